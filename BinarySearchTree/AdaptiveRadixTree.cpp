@@ -0,0 +1,96 @@
+#include <iostream>
+#include <chrono>
+#include <random>
+#include <vector>
+#include "BST.h"
+#include "AdaptiveRadixTree.h"
+using namespace std;
+
+/**
+ * Adaptive Radix Tree
+ *
+ * A radix tree does not compare whole keys. It reads the key one byte at a time and
+ * uses that byte to pick the next child, so a 4-byte int is found in at most 4 steps.
+ *
+ * Stick figure for the keys 0x0105, 0x0107 and 0x0203 (2-byte keys):
+ *
+ *              [01 02]          <- first byte
+ *             /       \
+ *        [05 07]      [03]      <- second byte
+ *
+ * In this figure:
+ * - The root has one child per distinct first byte.
+ * - A key exists if the path for all of its bytes exists.
+ * - Nodes start with room for 4 children and switch to 16, 48 and 256 as they fill up.
+ */
+
+/** Pointer tree used as a baseline */
+Node* insertPointer(Node* root, int data) {
+    Node** link = &root;
+    while (*link) {
+        link = (data < (*link)->data) ? &(*link)->left : &(*link)->right;
+    }
+    *link = new Node(data);
+    return root;
+}
+
+bool containsPointer(const Node* node, int data) {
+    while (node) {
+        if (data == node->data) return true;
+        node = (data < node->data) ? node->left : node->right;
+    }
+    return false;
+}
+
+template <typename F>
+long long timeMs(F f) {
+    auto start = chrono::steady_clock::now();
+    f();
+    return chrono::duration_cast<chrono::milliseconds>(chrono::steady_clock::now() - start).count();
+}
+
+int main() {
+    AdaptiveRadixTree<int> art;
+    for (int key : {50, -3, 300, 7, 70000, 12, -40000, 256}) {
+        art.insert(key);
+    }
+    cout << "In-order Traversal: ";
+    art.inorder();
+    cout << endl;
+
+    art.remove(300);
+    cout << "In-order Traversal after removing 300: ";
+    art.inorder();
+    cout << endl;
+    cout << "Contains 7: " << (art.contains(7) ? "yes" : "no") << endl;
+
+    const int n = 2000000;
+    mt19937 rng(5);
+    vector<int> keys(n);
+    for (int& key : keys) key = (int)rng();
+    vector<int> probes(n);
+    for (int i = 0; i < n; i++) probes[i] = (i % 2) ? keys[rng() % n] : (int)rng();
+
+    AdaptiveRadixTree<int> big;
+    Node* root = nullptr;
+    for (int key : keys) {
+        big.insert(key);
+        root = insertPointer(root, key);
+    }
+
+    size_t hits[2] = {0, 0};
+    long long artMs = timeMs([&] {
+        for (int probe : probes) hits[0] += big.contains(probe);
+    });
+    long long pointerMs = timeMs([&] {
+        for (int probe : probes) hits[1] += containsPointer(root, probe);
+    });
+
+    cout << "\n" << n << " lookups in " << big.size() << " keys:\n";
+    cout << "Adaptive radix tree: " << artMs << " ms (" << hits[0] << " hits), "
+         << big.memoryBytes() / (1 << 20) << " MB\n";
+    cout << "Pointer tree:        " << pointerMs << " ms (" << hits[1] << " hits)\n";
+
+    destroyTree(root);
+    return 0;
+}
@@ -0,0 +1,517 @@
+//
+//  AdaptiveRadixTree.h
+//  BinarySearchTrees
+//
+
+#ifndef AdaptiveRadixTree_h
+#define AdaptiveRadixTree_h
+
+#include <iostream>
+#include <cstdint>
+#include <cstring>
+#include <type_traits>
+
+#if defined(__SSE2__)
+#include <emmintrin.h>
+#elif defined(__ARM_NEON)
+#include <arm_neon.h>
+#endif
+
+using namespace std;
+
+// Adaptive radix tree (ART) for fixed-width integer keys.
+// A key is split into bytes, most significant first, and each level of the tree
+// branches on one byte. A lookup therefore visits at most sizeof(Key) nodes no matter
+// how many keys are stored, and compares single bytes instead of whole keys.
+// Inner nodes come in four sizes and grow or shrink with their number of children:
+//   Node4   - up to 4 sorted key bytes, linear search
+//   Node16  - up to 16 sorted key bytes, one SIMD compare finds the child
+//   Node48  - a 256-entry byte index into 48 child slots
+//   Node256 - a child pointer for every byte value
+// Signed keys have their sign bit flipped so byte order matches numeric order, which
+// keeps in-order iteration sorted.
+template <typename Key = int>
+class AdaptiveRadixTree {
+public:
+    static_assert(is_integral<Key>::value, "AdaptiveRadixTree needs an integer key");
+
+    AdaptiveRadixTree() : root(nullptr), count(0) {}
+
+    ~AdaptiveRadixTree() {
+        destroy(root, 0);
+    }
+
+    //copying would share nodes between two trees, use clone() for a deep copy
+    AdaptiveRadixTree(const AdaptiveRadixTree&) = delete;
+    AdaptiveRadixTree& operator=(const AdaptiveRadixTree&) = delete;
+
+    AdaptiveRadixTree(AdaptiveRadixTree&& other) noexcept : root(other.root), count(other.count) {
+        other.root = nullptr;
+        other.count = 0;
+    }
+
+    AdaptiveRadixTree& operator=(AdaptiveRadixTree&& other) noexcept {
+        if (this != &other) {
+            destroy(root, 0);
+            root = other.root;
+            count = other.count;
+            other.root = nullptr;
+            other.count = 0;
+        }
+        return *this;
+    }
+
+    //deep copy of the tree
+    AdaptiveRadixTree clone() const {
+        AdaptiveRadixTree copy;
+        copy.root = cloneNode(root, 0);
+        copy.count = count;
+        return copy;
+    }
+
+    //insert a key, returns false if it was already there
+    bool insert(Key key) {
+        UKey k = toUnsigned(key);
+        Node** ref = &root;
+        for (int depth = 0; depth < KeyBytes; depth++) {
+            if (!*ref) *ref = new Node4();
+            uint8_t b = byteAt(k, depth);
+            Node** slot = findChild(*ref, b);
+            if (depth == KeyBytes - 1) {
+                if (slot) return false;
+                addChild(*ref, b, leafMarker());
+                count++;
+                return true;
+            }
+            if (!slot) {
+                addChild(*ref, b, new Node4());
+                slot = findChild(*ref, b);
+            }
+            ref = slot;
+        }
+        return false;
+    }
+
+    //remove a key, returns false if it was not there
+    bool remove(Key key) {
+        UKey k = toUnsigned(key);
+        Node** path[KeyBytes];
+        Node** ref = &root;
+        for (int depth = 0; depth < KeyBytes; depth++) {
+            if (!*ref) return false;
+            path[depth] = ref;
+            Node** slot = findChild(*ref, byteAt(k, depth));
+            if (!slot) return false;
+            ref = slot;
+        }
+        // Unlink the key, then free any node that was left without children
+        for (int depth = KeyBytes - 1; depth >= 0; depth--) {
+            Node*& node = *path[depth];
+            removeChild(node, byteAt(k, depth));
+            if (node->count > 0) break;
+            freeNode(node);
+            node = nullptr;
+        }
+        count--;
+        return true;
+    }
+
+    //search for a key
+    bool contains(Key key) const {
+        UKey k = toUnsigned(key);
+        Node* node = root;
+        for (int depth = 0; depth < KeyBytes && node; depth++) {
+            Node** slot = findChild(node, byteAt(k, depth));
+            if (!slot) return false;
+            node = *slot;
+        }
+        return node != nullptr;
+    }
+
+    size_t size() const {
+        return count;
+    }
+
+    bool empty() const {
+        return count == 0;
+    }
+
+    //visit every key in increasing order
+    template <typename F>
+    void forEach(F visit) const {
+        walk(root, 0, 0, visit);
+    }
+
+    //inorder traversal
+    void inorder() const {
+        forEach([](Key key) { cout << key << " "; });
+    }
+
+    //bytes used by inner nodes
+    size_t memoryBytes() const {
+        return nodeBytes(root, 0);
+    }
+
+private:
+    typedef typename make_unsigned<Key>::type UKey;
+    static const int KeyBytes = sizeof(Key);
+
+    enum NodeType : uint8_t { Type4, Type16, Type48, Type256 };
+
+    struct Node {
+        NodeType type;
+        uint16_t count;
+        explicit Node(NodeType t) : type(t), count(0) {}
+    };
+
+    struct Node4 : Node {
+        uint8_t keys[4];
+        Node* children[4];
+        Node4() : Node(Type4) {}
+    };
+
+    struct Node16 : Node {
+        uint8_t keys[16];
+        Node* children[16];
+        Node16() : Node(Type16) {}
+    };
+
+    struct Node48 : Node {
+        uint8_t childIndex[256]; // slot + 1, or 0 for no child
+        Node* children[48];
+        Node48() : Node(Type48) {
+            memset(childIndex, 0, sizeof(childIndex));
+            memset(children, 0, sizeof(children));
+        }
+    };
+
+    struct Node256 : Node {
+        Node* children[256];
+        Node256() : Node(Type256) {
+            memset(children, 0, sizeof(children));
+        }
+    };
+
+    Node* root;
+    size_t count;
+
+    // Children on the last level only mark that the key exists
+    static Node* leafMarker() {
+        static Node4 marker;
+        return &marker;
+    }
+
+    static UKey toUnsigned(Key key) {
+        UKey k = (UKey)key;
+        if (is_signed<Key>::value) k ^= (UKey)1 << (KeyBytes * 8 - 1);
+        return k;
+    }
+
+    static Key fromUnsigned(UKey k) {
+        if (is_signed<Key>::value) k ^= (UKey)1 << (KeyBytes * 8 - 1);
+        return (Key)k;
+    }
+
+    static uint8_t byteAt(UKey k, int depth) {
+        return (uint8_t)(k >> (8 * (KeyBytes - 1 - depth)));
+    }
+
+    static Node** findChild(Node* node, uint8_t b) {
+        switch (node->type) {
+            case Type4: {
+                Node4* n = static_cast<Node4*>(node);
+                for (int i = 0; i < n->count; i++) {
+                    if (n->keys[i] == b) return &n->children[i];
+                }
+                return nullptr;
+            }
+            case Type16: {
+                Node16* n = static_cast<Node16*>(node);
+#if defined(__SSE2__)
+                __m128i cmp = _mm_cmpeq_epi8(_mm_set1_epi8((char)b),
+                                             _mm_loadu_si128(reinterpret_cast<__m128i*>(n->keys)));
+                unsigned mask = (unsigned)_mm_movemask_epi8(cmp) & ((1u << n->count) - 1);
+                return mask ? &n->children[__builtin_ctz(mask)] : nullptr;
+#elif defined(__ARM_NEON)
+                // Narrowing shift packs the 16 byte compares into 4 bits each
+                uint8x16_t cmp = vceqq_u8(vdupq_n_u8(b), vld1q_u8(n->keys));
+                uint64_t mask = vget_lane_u64(
+                    vreinterpret_u64_u8(vshrn_n_u16(vreinterpretq_u16_u8(cmp), 4)), 0);
+                if (n->count < 16) mask &= (1ULL << (4 * n->count)) - 1;
+                return mask ? &n->children[__builtin_ctzll(mask) >> 2] : nullptr;
+#else
+                for (int i = 0; i < n->count; i++) {
+                    if (n->keys[i] == b) return &n->children[i];
+                }
+                return nullptr;
+#endif
+            }
+            case Type48: {
+                Node48* n = static_cast<Node48*>(node);
+                return n->childIndex[b] ? &n->children[n->childIndex[b] - 1] : nullptr;
+            }
+            case Type256: {
+                Node256* n = static_cast<Node256*>(node);
+                return n->children[b] ? &n->children[b] : nullptr;
+            }
+        }
+        return nullptr;
+    }
+
+    // Insert into a sorted key/child array of a Node4 or Node16
+    template <typename N>
+    static void insertSorted(N* n, uint8_t b, Node* child) {
+        int pos = 0;
+        while (pos < n->count && n->keys[pos] < b) pos++;
+        memmove(n->keys + pos + 1, n->keys + pos, n->count - pos);
+        memmove(n->children + pos + 1, n->children + pos, (n->count - pos) * sizeof(Node*));
+        n->keys[pos] = b;
+        n->children[pos] = child;
+        n->count++;
+    }
+
+    // Add a child under byte b, growing the node into the next size when it is full
+    static void addChild(Node*& node, uint8_t b, Node* child) {
+        switch (node->type) {
+            case Type4: {
+                Node4* n = static_cast<Node4*>(node);
+                if (n->count < 4) {
+                    insertSorted(n, b, child);
+                    return;
+                }
+                Node16* bigger = new Node16();
+                memcpy(bigger->keys, n->keys, 4);
+                memcpy(bigger->children, n->children, 4 * sizeof(Node*));
+                bigger->count = 4;
+                delete n;
+                node = bigger;
+                insertSorted(bigger, b, child);
+                return;
+            }
+            case Type16: {
+                Node16* n = static_cast<Node16*>(node);
+                if (n->count < 16) {
+                    insertSorted(n, b, child);
+                    return;
+                }
+                Node48* bigger = new Node48();
+                for (int i = 0; i < 16; i++) {
+                    bigger->children[i] = n->children[i];
+                    bigger->childIndex[n->keys[i]] = (uint8_t)(i + 1);
+                }
+                bigger->count = 16;
+                delete n;
+                node = bigger;
+                addChild(node, b, child);
+                return;
+            }
+            case Type48: {
+                Node48* n = static_cast<Node48*>(node);
+                if (n->count < 48) {
+                    int slot = 0;
+                    while (n->children[slot]) slot++;
+                    n->children[slot] = child;
+                    n->childIndex[b] = (uint8_t)(slot + 1);
+                    n->count++;
+                    return;
+                }
+                Node256* bigger = new Node256();
+                for (int i = 0; i < 256; i++) {
+                    if (n->childIndex[i]) bigger->children[i] = n->children[n->childIndex[i] - 1];
+                }
+                bigger->count = 48;
+                delete n;
+                node = bigger;
+                addChild(node, b, child);
+                return;
+            }
+            case Type256: {
+                Node256* n = static_cast<Node256*>(node);
+                n->children[b] = child;
+                n->count++;
+                return;
+            }
+        }
+    }
+
+    // Remove the child under byte b, shrinking the node when it gets sparse
+    static void removeChild(Node*& node, uint8_t b) {
+        switch (node->type) {
+            case Type4:
+            case Type16: {
+                uint8_t* keys;
+                Node** children;
+                if (node->type == Type4) {
+                    keys = static_cast<Node4*>(node)->keys;
+                    children = static_cast<Node4*>(node)->children;
+                } else {
+                    keys = static_cast<Node16*>(node)->keys;
+                    children = static_cast<Node16*>(node)->children;
+                }
+                int pos = 0;
+                while (keys[pos] != b) pos++;
+                memmove(keys + pos, keys + pos + 1, node->count - pos - 1);
+                memmove(children + pos, children + pos + 1, (node->count - pos - 1) * sizeof(Node*));
+                node->count--;
+                if (node->type == Type16 && node->count <= 3) {
+                    Node16* n = static_cast<Node16*>(node);
+                    Node4* smaller = new Node4();
+                    memcpy(smaller->keys, n->keys, n->count);
+                    memcpy(smaller->children, n->children, n->count * sizeof(Node*));
+                    smaller->count = n->count;
+                    delete n;
+                    node = smaller;
+                }
+                return;
+            }
+            case Type48: {
+                Node48* n = static_cast<Node48*>(node);
+                n->children[n->childIndex[b] - 1] = nullptr;
+                n->childIndex[b] = 0;
+                n->count--;
+                if (n->count <= 12) {
+                    Node16* smaller = new Node16();
+                    for (int i = 0; i < 256; i++) {
+                        if (n->childIndex[i]) {
+                            smaller->keys[smaller->count] = (uint8_t)i;
+                            smaller->children[smaller->count] = n->children[n->childIndex[i] - 1];
+                            smaller->count++;
+                        }
+                    }
+                    delete n;
+                    node = smaller;
+                }
+                return;
+            }
+            case Type256: {
+                Node256* n = static_cast<Node256*>(node);
+                n->children[b] = nullptr;
+                n->count--;
+                if (n->count <= 40) {
+                    Node48* smaller = new Node48();
+                    for (int i = 0; i < 256; i++) {
+                        if (n->children[i]) {
+                            smaller->children[smaller->count] = n->children[i];
+                            smaller->childIndex[i] = (uint8_t)(smaller->count + 1);
+                            smaller->count++;
+                        }
+                    }
+                    delete n;
+                    node = smaller;
+                }
+                return;
+            }
+        }
+    }
+
+    static void freeNode(Node* node) {
+        switch (node->type) {
+            case Type4: delete static_cast<Node4*>(node); break;
+            case Type16: delete static_cast<Node16*>(node); break;
+            case Type48: delete static_cast<Node48*>(node); break;
+            case Type256: delete static_cast<Node256*>(node); break;
+        }
+    }
+
+    // Calls f(byte, child) for every child in increasing byte order
+    template <typename F>
+    static void eachChild(const Node* node, F f) {
+        switch (node->type) {
+            case Type4: {
+                const Node4* n = static_cast<const Node4*>(node);
+                for (int i = 0; i < n->count; i++) f(n->keys[i], n->children[i]);
+                return;
+            }
+            case Type16: {
+                const Node16* n = static_cast<const Node16*>(node);
+                for (int i = 0; i < n->count; i++) f(n->keys[i], n->children[i]);
+                return;
+            }
+            case Type48: {
+                const Node48* n = static_cast<const Node48*>(node);
+                for (int i = 0; i < 256; i++) {
+                    if (n->childIndex[i]) f((uint8_t)i, n->children[n->childIndex[i] - 1]);
+                }
+                return;
+            }
+            case Type256: {
+                const Node256* n = static_cast<const Node256*>(node);
+                for (int i = 0; i < 256; i++) {
+                    if (n->children[i]) f((uint8_t)i, n->children[i]);
+                }
+                return;
+            }
+        }
+    }
+
+    // Tree depth is at most sizeof(Key), so recursion is shallow
+    static void destroy(Node* node, int depth) {
+        if (!node) return;
+        if (depth < KeyBytes - 1) {
+            eachChild(node, [depth](uint8_t, Node* child) { destroy(child, depth + 1); });
+        }
+        freeNode(node);
+    }
+
+    static Node* cloneNode(const Node* node, int depth) {
+        if (!node) return nullptr;
+        Node* copy = nullptr;
+        switch (node->type) {
+            case Type4: copy = new Node4(*static_cast<const Node4*>(node)); break;
+            case Type16: copy = new Node16(*static_cast<const Node16*>(node)); break;
+            case Type48: copy = new Node48(*static_cast<const Node48*>(node)); break;
+            case Type256: copy = new Node256(*static_cast<const Node256*>(node)); break;
+        }
+        if (depth == KeyBytes - 1) return copy;
+        switch (copy->type) {
+            case Type4: {
+                Node4* n = static_cast<Node4*>(copy);
+                for (int i = 0; i < n->count; i++) n->children[i] = cloneNode(n->children[i], depth + 1);
+                break;
+            }
+            case Type16: {
+                Node16* n = static_cast<Node16*>(copy);
+                for (int i = 0; i < n->count; i++) n->children[i] = cloneNode(n->children[i], depth + 1);
+                break;
+            }
+            case Type48: {
+                Node48* n = static_cast<Node48*>(copy);
+                for (int i = 0; i < 48; i++) n->children[i] = cloneNode(n->children[i], depth + 1);
+                break;
+            }
+            case Type256: {
+                Node256* n = static_cast<Node256*>(copy);
+                for (int i = 0; i < 256; i++) n->children[i] = cloneNode(n->children[i], depth + 1);
+                break;
+            }
+        }
+        return copy;
+    }
+
+    template <typename F>
+    static void walk(const Node* node, int depth, UKey prefix, F& visit) {
+        if (!node) return;
+        eachChild(node, [&](uint8_t b, const Node* child) {
+            UKey k = prefix | ((UKey)b << (8 * (KeyBytes - 1 - depth)));
+            if (depth == KeyBytes - 1) visit(fromUnsigned(k));
+            else walk(child, depth + 1, k, visit);
+        });
+    }
+
+    static size_t nodeBytes(const Node* node, int depth) {
+        if (!node) return 0;
+        size_t bytes = 0;
+        switch (node->type) {
+            case Type4: bytes = sizeof(Node4); break;
+            case Type16: bytes = sizeof(Node16); break;
+            case Type48: bytes = sizeof(Node48); break;
+            case Type256: bytes = sizeof(Node256); break;
+        }
+        if (depth < KeyBytes - 1) {
+            eachChild(node, [&](uint8_t, const Node* child) { bytes += nodeBytes(child, depth + 1); });
+        }
+        return bytes;
+    }
+};
+
+#endif /* AdaptiveRadixTree_h */
@@ -0,0 +1,334 @@
+//
+//  AggregateTree.h
+//  BinarySearchTrees
+//
+
+#ifndef AggregateTree_h
+#define AggregateTree_h
+
+#include <iostream>
+#include <algorithm>
+#include <climits>
+#include <utility>
+#include <vector>
+
+using namespace std;
+
+// Monoids for AggregateTree. A monoid says what a single key contributes (lift),
+// how two neighbouring results are joined (combine), and what an empty range gives
+// (identity). combine only has to be associative: results are always joined in key order.
+struct SumMonoid {
+    typedef long long Value;
+    static Value identity() { return 0; }
+    static Value lift(int key) { return key; }
+    static Value combine(Value a, Value b) { return a + b; }
+};
+
+struct MinMonoid {
+    typedef int Value;
+    static Value identity() { return INT_MAX; }
+    static Value lift(int key) { return key; }
+    static Value combine(Value a, Value b) { return min(a, b); }
+};
+
+struct MaxMonoid {
+    typedef int Value;
+    static Value identity() { return INT_MIN; }
+    static Value lift(int key) { return key; }
+    static Value combine(Value a, Value b) { return max(a, b); }
+};
+
+struct CountMonoid {
+    typedef size_t Value;
+    static Value identity() { return 0; }
+    static Value lift(int) { return 1; }
+    static Value combine(Value a, Value b) { return a + b; }
+};
+
+// Search tree where every node also stores Monoid's result for its whole subtree.
+// Insert and remove recompute the aggregate of each node on the way back up, and
+// rotations recompute the two nodes they move, so aggregate(lo, hi) only has to
+// combine O(log n) stored subtree results instead of visiting every key in range.
+// With Balanced = true the tree rebalances like AVLTree and ignores duplicate keys;
+// with Balanced = false it behaves like the plain BST and sends duplicates right.
+template <typename Monoid, bool Balanced = true>
+class AggregateTree {
+public:
+    typedef typename Monoid::Value Value;
+
+    struct Node {
+        int key;
+        int height;
+        Node* left;
+        Node* right;
+        Value agg; // Monoid over this node's subtree
+        Node(int k) : key(k), height(1), left(nullptr), right(nullptr), agg(Monoid::lift(k)) {}
+    };
+
+    Node* root;
+
+    AggregateTree() : root(nullptr), count(0) {}
+
+    ~AggregateTree() {
+        destroyTree(root);
+    }
+
+    //copying would share nodes between two trees, use clone() for a deep copy
+    AggregateTree(const AggregateTree&) = delete;
+    AggregateTree& operator=(const AggregateTree&) = delete;
+
+    AggregateTree(AggregateTree&& other) noexcept : root(other.root), count(other.count) {
+        other.root = nullptr;
+        other.count = 0;
+    }
+
+    AggregateTree& operator=(AggregateTree&& other) noexcept {
+        if (this != &other) {
+            destroyTree(root);
+            root = other.root;
+            count = other.count;
+            other.root = nullptr;
+            other.count = 0;
+        }
+        return *this;
+    }
+
+    //deep copy of the tree
+    AggregateTree clone() const {
+        AggregateTree copy;
+        copy.root = cloneTree(root);
+        copy.count = count;
+        return copy;
+    }
+
+    //perfectly balanced tree over keys[begin, end), which must be sorted (and distinct
+    //when Balanced); O(n) instead of n inserts
+    static AggregateTree fromSorted(const vector<int>& keys, size_t begin, size_t end) {
+        AggregateTree tree;
+        tree.root = buildSorted(keys, begin, end);
+        tree.count = end - begin;
+        return tree;
+    }
+
+    void insert(int key) {
+        root = insert(root, key);
+    }
+
+    void remove(int key) {
+        root = deleteNode(root, key);
+    }
+
+    bool contains(int key) const {
+        const Node* node = root;
+        while (node && node->key != key) {
+            node = (key < node->key) ? node->left : node->right;
+        }
+        return node != nullptr;
+    }
+
+    size_t size() const {
+        return count;
+    }
+
+    //Monoid over every key in [lo, hi], O(height)
+    Value aggregate(int lo, int hi) const {
+        if (lo > hi) return Monoid::identity();
+        //walk down to the first node inside the range, where the paths to lo and hi split
+        const Node* split = root;
+        while (split && (split->key < lo || split->key > hi)) {
+            split = (split->key < lo) ? split->right : split->left;
+        }
+        if (!split) return Monoid::identity();
+
+        //left boundary: every node >= lo brings itself and its whole right subtree
+        Value leftPart = Monoid::identity();
+        for (const Node* node = split->left; node;) {
+            if (node->key >= lo) {
+                leftPart = Monoid::combine(Monoid::combine(Monoid::lift(node->key), agg(node->right)), leftPart);
+                node = node->left;
+            } else {
+                node = node->right;
+            }
+        }
+        //right boundary: every node <= hi brings its whole left subtree and itself
+        Value rightPart = Monoid::identity();
+        for (const Node* node = split->right; node;) {
+            if (node->key <= hi) {
+                rightPart = Monoid::combine(rightPart, Monoid::combine(agg(node->left), Monoid::lift(node->key)));
+                node = node->right;
+            } else {
+                node = node->left;
+            }
+        }
+        return Monoid::combine(leftPart, Monoid::combine(Monoid::lift(split->key), rightPart));
+    }
+
+    //Monoid over the whole tree, O(1)
+    Value aggregate() const {
+        return agg(root);
+    }
+
+    //keys in [lo, hi] in sorted order, O(log n + k)
+    vector<int> collect(int lo, int hi) const {
+        vector<int> keys;
+        vector<const Node*> path;
+        const Node* node = root;
+        while (node || !path.empty()) {
+            while (node) {
+                path.push_back(node);
+                node = (node->key >= lo) ? node->left : nullptr;
+            }
+            node = path.back();
+            path.pop_back();
+            if (node->key > hi) break;
+            if (node->key >= lo) keys.push_back(node->key);
+            node = node->right;
+        }
+        return keys;
+    }
+
+    //inorder traversal
+    void inorder() const {
+        vector<int> keys = collect(INT_MIN, INT_MAX);
+        for (int key : keys) cout << key << " ";
+        cout << endl;
+    }
+
+private:
+    size_t count;
+
+    static Value agg(const Node* node) {
+        return node ? node->agg : Monoid::identity();
+    }
+
+    static int height(const Node* node) {
+        return node ? node->height : 0;
+    }
+
+    static int getBalance(const Node* node) {
+        return node ? height(node->left) - height(node->right) : 0;
+    }
+
+    static Node* buildSorted(const vector<int>& keys, size_t begin, size_t end) {
+        if (begin >= end) return nullptr;
+        size_t mid = begin + (end - begin) / 2;
+        Node* node = new Node(keys[mid]);
+        node->left = buildSorted(keys, begin, mid);
+        node->right = buildSorted(keys, mid + 1, end);
+        pull(node);
+        return node;
+    }
+
+    //recompute height and aggregate from the children
+    static void pull(Node* node) {
+        node->height = max(height(node->left), height(node->right)) + 1;
+        node->agg = Monoid::combine(Monoid::combine(agg(node->left), Monoid::lift(node->key)), agg(node->right));
+    }
+
+    static Node* rightRotate(Node* y) {
+        Node* x = y->left;
+        y->left = x->right;
+        x->right = y;
+        pull(y);
+        pull(x);
+        return x;
+    }
+
+    static Node* leftRotate(Node* x) {
+        Node* y = x->right;
+        x->right = y->left;
+        y->left = x;
+        pull(x);
+        pull(y);
+        return y;
+    }
+
+    //fix the aggregate and, in balanced mode, the shape of the node after a change below it
+    static Node* rebalance(Node* node) {
+        pull(node);
+        if (!Balanced) return node;
+        int balance = getBalance(node);
+        if (balance > 1) {
+            if (getBalance(node->left) < 0) node->left = leftRotate(node->left);
+            return rightRotate(node);
+        }
+        if (balance < -1) {
+            if (getBalance(node->right) > 0) node->right = rightRotate(node->right);
+            return leftRotate(node);
+        }
+        return node;
+    }
+
+    Node* insert(Node* node, int key) {
+        if (!node) {
+            count++;
+            return new Node(key);
+        }
+        if (key < node->key) {
+            node->left = insert(node->left, key);
+        } else if (key > node->key || !Balanced) {
+            node->right = insert(node->right, key);
+        } else {
+            return node;
+        }
+        return rebalance(node);
+    }
+
+    Node* deleteNode(Node* node, int key) {
+        if (!node) return nullptr;
+        if (key < node->key) {
+            node->left = deleteNode(node->left, key);
+        } else if (key > node->key) {
+            node->right = deleteNode(node->right, key);
+        } else {
+            if (!node->left || !node->right) {
+                Node* child = node->left ? node->left : node->right;
+                delete node;
+                count--;
+                return child;
+            }
+            //two children: take the key of the inorder successor and delete that instead
+            Node* successor = node->right;
+            while (successor->left) successor = successor->left;
+            node->key = successor->key;
+            node->right = deleteNode(node->right, successor->key);
+        }
+        return rebalance(node);
+    }
+
+    void destroyTree(Node* node) {
+        while (node) {
+            if (node->left) {
+                Node* left = node->left;
+                node->left = left->right;
+                left->right = node;
+                node = left;
+            } else {
+                Node* right = node->right;
+                delete node;
+                node = right;
+            }
+        }
+    }
+
+    Node* cloneTree(const Node* source) const {
+        if (!source) return nullptr;
+        Node* copy = new Node(*source);
+        vector<Node*> pending(1, copy);
+        while (!pending.empty()) {
+            Node* to = pending.back();
+            pending.pop_back();
+            if (to->left) {
+                to->left = new Node(*to->left);
+                pending.push_back(to->left);
+            }
+            if (to->right) {
+                to->right = new Node(*to->right);
+                pending.push_back(to->right);
+            }
+        }
+        return copy;
+    }
+};
+
+#endif /* AggregateTree_h */
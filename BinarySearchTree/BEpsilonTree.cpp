@@ -0,0 +1,81 @@
+#include <iostream>
+#include <chrono>
+#include <random>
+#include <vector>
+#include "BST.h"
+#include "BEpsilonTree.h"
+using namespace std;
+
+/**
+ * B-Epsilon Tree
+ *
+ * Inserting into a search tree means walking down to the right leaf every time, and in a
+ * big tree most of those steps miss the cache. A B-epsilon tree lets updates wait in a
+ * buffer inside each internal node and sends them down in batches.
+ *
+ * Stick figure (buffers in braces, +k is an insert, -k a delete):
+ *
+ *                 [ 50 ]  { +7 +61 -12 +55 }
+ *                /      \
+ *     [ 10 12 30 ]      [ 52 60 70 ]
+ *
+ * In this figure:
+ * - The four updates have only touched the root so far.
+ * - Once the buffer is full, +61 and +55 go down to the right leaf together.
+ * - contains(12) finds -12 in the root buffer and answers "no" without reading the leaf,
+ *   because a message higher up is always newer than anything below it.
+ */
+
+/** Pointer tree used as a baseline */
+Node* insertPointer(Node* root, int data) {
+    Node** link = &root;
+    while (*link) {
+        if (data == (*link)->data) return root;
+        link = (data < (*link)->data) ? &(*link)->left : &(*link)->right;
+    }
+    *link = new Node(data);
+    return root;
+}
+
+template <typename F>
+long long timeMs(F f) {
+    auto start = chrono::steady_clock::now();
+    f();
+    return chrono::duration_cast<chrono::milliseconds>(chrono::steady_clock::now() - start).count();
+}
+
+int main() {
+    BEpsilonTree tree(3, 4, 3);
+    for (int key : {10, 12, 30, 50, 52, 60, 70, 7, 61, 55}) {
+        tree.insert(key);
+    }
+    tree.remove(12);
+    cout << "In-order Traversal: ";
+    tree.inorder();
+    cout << "Contains 12: " << (tree.contains(12) ? "yes" : "no") << ", messages still buffered: "
+         << tree.pendingMessages() << endl;
+
+    const int n = 4000000;
+    mt19937 rng(12);
+    vector<int> keys(n);
+    for (int& key : keys) key = (int)rng();
+
+    BEpsilonTree big;
+    Node* root = nullptr;
+    long long bepsilonMs = timeMs([&] {
+        for (int key : keys) big.insert(key);
+    });
+    long long pointerMs = timeMs([&] {
+        for (int key : keys) root = insertPointer(root, key);
+    });
+
+    BEpsilonTree::Stats stats = big.stats();
+    cout << "\n" << n << " random inserts:\n";
+    cout << "B-epsilon tree: " << bepsilonMs << " ms, " << stats.flushes << " batches averaging "
+         << stats.messagesMoved / max<size_t>(stats.flushes, 1) << " messages\n";
+    cout << "Pointer tree:   " << pointerMs << " ms\n";
+    cout << "Contains keys[0]: " << (big.contains(keys[0]) ? "yes" : "no") << ", keys stored: " << big.size() << endl;
+
+    destroyTree(root);
+    return 0;
+}
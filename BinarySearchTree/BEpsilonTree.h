@@ -0,0 +1,335 @@
+//
+//  BEpsilonTree.h
+//  BinarySearchTrees
+//
+
+#ifndef BEpsilonTree_h
+#define BEpsilonTree_h
+
+#include <iostream>
+#include <algorithm>
+#include <climits>
+#include <stdexcept>
+#include <vector>
+
+using namespace std;
+
+// Write-optimized B-epsilon tree of ints.
+// Leaves hold sorted keys like a B+tree, but every internal node also has a buffer of
+// pending inserts and deletes ("messages"). insert() and remove() only append a message
+// to the root's buffer. When a buffer fills up, the messages headed for its busiest child
+// move down together, so one node visit carries many updates and a random insert costs a
+// fraction of a descent instead of a full one.
+// Messages higher up are always newer than those below them, so contains() and
+// collect() stay exact by letting the first message found on the way down win over
+// anything deeper. Each buffer is sorted by key and keeps only the newest message for a key,
+// so a lookup binary searches it and the messages headed for one child sit in one run.
+// Updates are blind: insert() does not know whether the key was already
+// there, which is why size() has to count.
+// Leaves emptied by deletes are not merged with their neighbours.
+class BEpsilonTree {
+public:
+    struct Stats {
+        size_t flushes;       // batches moved from a buffer into a child
+        size_t messagesMoved; // messages carried by those batches
+        size_t splits;        // leaves and internal nodes split
+    };
+
+    BEpsilonTree(size_t fanout = 16, size_t bufferCapacity = 1024, size_t leafCapacity = 256)
+        : root(new Node(true)), fanout(fanout), bufferCapacity(bufferCapacity),
+          leafCapacity(leafCapacity), counters{0, 0, 0} {
+        if (fanout < 3 || bufferCapacity < fanout || leafCapacity < 2) {
+            delete root;
+            throw invalid_argument("BEpsilonTree: needs fanout >= 3, bufferCapacity >= fanout, leafCapacity >= 2");
+        }
+    }
+
+    ~BEpsilonTree() {
+        destroyTree(root);
+    }
+
+    //copying would share nodes between two trees, use clone() for a deep copy
+    BEpsilonTree(const BEpsilonTree&) = delete;
+    BEpsilonTree& operator=(const BEpsilonTree&) = delete;
+
+    BEpsilonTree(BEpsilonTree&& other) noexcept
+        : root(other.root), fanout(other.fanout), bufferCapacity(other.bufferCapacity),
+          leafCapacity(other.leafCapacity), counters(other.counters) {
+        other.root = nullptr;
+    }
+
+    BEpsilonTree& operator=(BEpsilonTree&& other) noexcept {
+        if (this != &other) {
+            destroyTree(root);
+            root = other.root;
+            fanout = other.fanout;
+            bufferCapacity = other.bufferCapacity;
+            leafCapacity = other.leafCapacity;
+            counters = other.counters;
+            other.root = nullptr;
+        }
+        return *this;
+    }
+
+    //deep copy of the tree, buffers included
+    BEpsilonTree clone() const {
+        BEpsilonTree copy(fanout, bufferCapacity, leafCapacity);
+        delete copy.root;
+        copy.root = cloneTree(root);
+        copy.counters = counters;
+        return copy;
+    }
+
+    /** Task 2: Insert a key */
+    void insert(int key) {
+        apply(Message{key, true});
+    }
+
+    /** Task 3: Remove a key */
+    void remove(int key) {
+        apply(Message{key, false});
+    }
+
+    /** Search for a key; the newest message on the path decides */
+    bool contains(int key) const {
+        const Node* node = root;
+        while (!node->leaf) {
+            auto it = lower_bound(node->buffer.begin(), node->buffer.end(), key, MessageKey());
+            if (it != node->buffer.end() && it->key == key) return it->insert;
+            node = node->children[childIndex(node, key)];
+        }
+        return binary_search(node->keys.begin(), node->keys.end(), key);
+    }
+
+    /** Keys in [lo, hi] in sorted order */
+    vector<int> collect(int lo, int hi) const {
+        vector<int> keys;
+        if (lo <= hi) collect(root, lo, hi, keys);
+        return keys;
+    }
+
+    /** Task 4: Perform an in-order traversal */
+    void inorder() const {
+        for (int key : collect(INT_MIN, INT_MAX)) cout << key << " ";
+        cout << endl;
+    }
+
+    // Number of keys, O(n): pending messages have to be resolved to know it
+    size_t size() const {
+        return collect(INT_MIN, INT_MAX).size();
+    }
+
+    // Messages still waiting in buffers
+    size_t pendingMessages() const {
+        return pending(root);
+    }
+
+    Stats stats() const {
+        return counters;
+    }
+
+private:
+    struct Message {
+        int key;
+        bool insert; // false: delete
+    };
+
+    // Orders messages by key, for searching a buffer with a plain key
+    struct MessageKey {
+        bool operator()(const Message& message, int key) const { return message.key < key; }
+        bool operator()(int key, const Message& message) const { return key < message.key; }
+    };
+
+    struct Node {
+        bool leaf;
+        vector<int> keys;        // leaf: sorted keys, internal: pivots between children
+        vector<Node*> children;  // children[i] holds keys in [keys[i - 1], keys[i])
+        vector<Message> buffer;  // internal only, sorted by key, newest message per key
+
+        explicit Node(bool leaf) : leaf(leaf) {}
+    };
+
+    Node* root;
+    size_t fanout;
+    size_t bufferCapacity;
+    size_t leafCapacity;
+    Stats counters;
+
+    static size_t childIndex(const Node* node, int key) {
+        return upper_bound(node->keys.begin(), node->keys.end(), key) - node->keys.begin();
+    }
+
+    void apply(const Message& message) {
+        if (root->leaf) {
+            applyToLeaf(root, &message, &message + 1);
+        } else {
+            mergeMessages(root->buffer, &message, &message + 1);
+            if (root->buffer.size() > bufferCapacity) flush(root);
+        }
+        while (overfull(root)) {
+            Node* top = new Node(false);
+            top->children.push_back(root);
+            root = top;
+            splitChildren(root);
+        }
+    }
+
+    bool overfull(const Node* node) const {
+        return node->leaf ? node->keys.size() > leafCapacity : node->children.size() > fanout;
+    }
+
+    //move the messages for the child with the most of them down, until the buffer fits
+    void flush(Node* node) {
+        while (node->buffer.size() > bufferCapacity) {
+            // children[i] gets the run of messages below pivot keys[i]
+            size_t target = 0, from = 0, most = 0, begin = 0;
+            for (size_t i = 0; i < node->children.size(); i++) {
+                size_t end = node->buffer.size();
+                if (i < node->keys.size()) {
+                    end = lower_bound(node->buffer.begin() + begin, node->buffer.end(), node->keys[i], MessageKey())
+                          - node->buffer.begin();
+                }
+                if (end - begin > most) {
+                    target = i;
+                    from = begin;
+                    most = end - begin;
+                }
+                begin = end;
+            }
+
+            vector<Message> moving(node->buffer.begin() + from, node->buffer.begin() + from + most);
+            node->buffer.erase(node->buffer.begin() + from, node->buffer.begin() + from + most);
+            counters.flushes++;
+            counters.messagesMoved += moving.size();
+
+            Node* child = node->children[target];
+            if (child->leaf) {
+                applyToLeaf(child, moving.data(), moving.data() + moving.size());
+            } else {
+                // Moved messages are newer than the child's own, so they win on equal keys
+                mergeMessages(child->buffer, moving.data(), moving.data() + moving.size());
+                if (child->buffer.size() > bufferCapacity) flush(child);
+            }
+            splitChildren(node);
+        }
+    }
+
+    //merge newer messages (sorted, one per key) into a buffer; a newer message replaces an older one for its key
+    static void mergeMessages(vector<Message>& buffer, const Message* begin, const Message* end) {
+        if (end - begin == 1) {
+            auto it = lower_bound(buffer.begin(), buffer.end(), begin->key, MessageKey());
+            if (it != buffer.end() && it->key == begin->key) {
+                *it = *begin;
+            } else {
+                buffer.insert(it, *begin);
+            }
+            return;
+        }
+        vector<Message> merged;
+        merged.reserve(buffer.size() + (end - begin));
+        size_t k = 0;
+        for (const Message* message = begin; message != end; ++message) {
+            while (k < buffer.size() && buffer[k].key < message->key) merged.push_back(buffer[k++]);
+            if (k < buffer.size() && buffer[k].key == message->key) k++;
+            merged.push_back(*message);
+        }
+        merged.insert(merged.end(), buffer.begin() + k, buffer.end());
+        buffer.swap(merged);
+    }
+
+    //merge messages (sorted, one per key) into a leaf's sorted keys
+    static void applyToLeaf(Node* leaf, const Message* begin, const Message* end) {
+        vector<int> merged;
+        merged.reserve(leaf->keys.size() + (end - begin));
+        size_t k = 0;
+        for (const Message* message = begin; message != end; ++message) {
+            int key = message->key;
+            while (k < leaf->keys.size() && leaf->keys[k] < key) merged.push_back(leaf->keys[k++]);
+            if (k < leaf->keys.size() && leaf->keys[k] == key) k++;
+            if (message->insert) merged.push_back(key);
+        }
+        merged.insert(merged.end(), leaf->keys.begin() + k, leaf->keys.end());
+        leaf->keys.swap(merged);
+    }
+
+    //split every child of node that grew past its capacity
+    void splitChildren(Node* node) {
+        for (size_t i = 0; i < node->children.size(); i++) {
+            while (overfull(node->children[i])) splitChild(node, i);
+        }
+    }
+
+    //split children[i] in half; the right half becomes children[i + 1]
+    void splitChild(Node* parent, size_t i) {
+        Node* left = parent->children[i];
+        Node* right = new Node(left->leaf);
+        int pivot;
+        if (left->leaf) {
+            size_t half = left->keys.size() / 2;
+            right->keys.assign(left->keys.begin() + half, left->keys.end());
+            left->keys.resize(half);
+            pivot = right->keys.front();
+        } else {
+            size_t half = left->children.size() / 2;
+            pivot = left->keys[half - 1];
+            right->keys.assign(left->keys.begin() + half, left->keys.end());
+            right->children.assign(left->children.begin() + half, left->children.end());
+            left->keys.resize(half - 1);
+            left->children.resize(half);
+            auto at = lower_bound(left->buffer.begin(), left->buffer.end(), pivot, MessageKey());
+            right->buffer.assign(at, left->buffer.end());
+            left->buffer.erase(at, left->buffer.end());
+        }
+        parent->keys.insert(parent->keys.begin() + i, pivot);
+        parent->children.insert(parent->children.begin() + i + 1, right);
+        counters.splits++;
+    }
+
+    //keys of node's subtree in [lo, hi], with node's own buffer applied on top
+    static void collect(const Node* node, int lo, int hi, vector<int>& out) {
+        if (node->leaf) {
+            auto from = lower_bound(node->keys.begin(), node->keys.end(), lo);
+            auto to = upper_bound(node->keys.begin(), node->keys.end(), hi);
+            out.insert(out.end(), from, to);
+            return;
+        }
+        vector<int> below;
+        size_t first = childIndex(node, lo), last = childIndex(node, hi);
+        for (size_t i = first; i <= last; i++) collect(node->children[i], lo, hi, below);
+
+        auto from = lower_bound(node->buffer.begin(), node->buffer.end(), lo, MessageKey());
+        auto to = upper_bound(from, node->buffer.end(), hi, MessageKey());
+        if (from == to) {
+            out.insert(out.end(), below.begin(), below.end());
+            return;
+        }
+        size_t k = 0;
+        for (auto message = from; message != to; ++message) {
+            int key = message->key;
+            while (k < below.size() && below[k] < key) out.push_back(below[k++]);
+            if (k < below.size() && below[k] == key) k++;
+            if (message->insert) out.push_back(key);
+        }
+        out.insert(out.end(), below.begin() + k, below.end());
+    }
+
+    static size_t pending(const Node* node) {
+        size_t total = node->buffer.size();
+        for (const Node* child : node->children) total += pending(child);
+        return total;
+    }
+
+    static void destroyTree(Node* node) {
+        if (!node) return;
+        for (Node* child : node->children) destroyTree(child);
+        delete node;
+    }
+
+    static Node* cloneTree(const Node* node) {
+        Node* copy = new Node(*node);
+        for (Node*& child : copy->children) child = cloneTree(child);
+        return copy;
+    }
+};
+
+#endif /* BEpsilonTree_h */
@@ -13,17 +13,69 @@
 #include <string>
 #include <cmath>
 #include <unordered_map>
+#include <utility>
 
 using namespace std;
 
 // Node structure for the tree
 struct Node {
     int data;
+    int count; // occurrences of data when a tree counts duplicates, otherwise 1
     Node* left;
     Node* right;
-    Node(int val) : data(val), left(nullptr), right(nullptr) {}
+    Node(int val) : data(val), count(1), left(nullptr), right(nullptr) {}
 };
 
+// Print a node's key once per occurrence, so every traversal of a counted tree shows
+// the same multiset
+inline void printKey(const Node* node) {
+    for (int i = 0; i < node->count; i++) cout << node->data << " ";
+}
+
+// Free every node of a tree without recursion.
+// A node with a left child is rotated right until it has none, then it is freed and we
+// move on to its right child. Every rotation moves one node onto the right spine for
+// good, so even a degenerate tree is torn down in O(n) time and O(1) extra space.
+inline void destroyTree(Node* node) {
+    while (node) {
+        if (node->left) {
+            Node* left = node->left;
+            node->left = left->right;
+            left->right = node;
+            node = left;
+        } else {
+            Node* right = node->right;
+            delete node;
+            node = right;
+        }
+    }
+}
+
+// Deep copy of a tree, walking it with an explicit stack instead of recursion
+inline Node* cloneTree(const Node* root) {
+    if (!root) return nullptr;
+    Node* copy = new Node(root->data);
+    copy->count = root->count;
+    vector<pair<const Node*, Node*>> pending;
+    pending.push_back(make_pair(root, copy));
+    while (!pending.empty()) {
+        const Node* source = pending.back().first;
+        Node* target = pending.back().second;
+        pending.pop_back();
+        if (source->left) {
+            target->left = new Node(source->left->data);
+            target->left->count = source->left->count;
+            pending.push_back(make_pair(source->left, target->left));
+        }
+        if (source->right) {
+            target->right = new Node(source->right->data);
+            target->right->count = source->right->count;
+            pending.push_back(make_pair(source->right, target->right));
+        }
+    }
+    return copy;
+}
+
 // Define the class
 class BSTPrinter {
 public:
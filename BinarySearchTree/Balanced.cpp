@@ -1,7 +1,16 @@
 #include <iostream>
+#include <algorithm>
+#include <cstdio>
+#include <fstream>
 #include <queue>
 #include <stack>
+#include <memory>
+#include <new>
 #include "BST.h"
+#include "BloomFilter.h"
+#include "KeyImport.h"
+#include "NodeArena.h"
+#include "ParallelSort.h"
 using namespace std;
 
 /**
@@ -27,16 +36,82 @@ using namespace std;
 class BST {
 public:
     Node* root;
+    bool countDuplicates; // multiset mode: one node per key plus an occurrence count
+    unique_ptr<BloomFilter> filter; // optional, see enableFilter()
+    size_t removedSinceRebuild;
+    vector<int> sortedView;     // cached keys in order, see sortedKeys()
+    vector<int> pendingInserts; // changes not merged into sortedView yet
+    vector<int> pendingRemoves;
+    bool viewValid;
+    unique_ptr<NodeArena<Node>> arena; // set by the bulk builders, then every node comes from it
+
+    explicit BST(bool countDuplicates = false)
+        : root(nullptr), countDuplicates(countDuplicates), removedSinceRebuild(0), viewValid(false) {}
+
+    ~BST() {
+        // Arena nodes go with the arena
+        if (!arena) destroyTree(root);
+    }
+
+    // A copy would share nodes with this tree, use clone() for a deep copy
+    BST(const BST&) = delete;
+    BST& operator=(const BST&) = delete;
+
+    BST(BST&& other) noexcept
+        : root(other.root), countDuplicates(other.countDuplicates), filter(move(other.filter)),
+          removedSinceRebuild(other.removedSinceRebuild), sortedView(move(other.sortedView)),
+          pendingInserts(move(other.pendingInserts)), pendingRemoves(move(other.pendingRemoves)),
+          viewValid(other.viewValid), arena(move(other.arena)) {
+        other.root = nullptr;
+        other.viewValid = false;
+    }
 
-    BST() : root(nullptr) {}
+    BST& operator=(BST&& other) noexcept {
+        if (this != &other) {
+            if (!arena) destroyTree(root);
+            arena = move(other.arena);
+            root = other.root;
+            other.root = nullptr;
+            countDuplicates = other.countDuplicates;
+            filter = move(other.filter);
+            removedSinceRebuild = other.removedSinceRebuild;
+            sortedView = move(other.sortedView);
+            pendingInserts = move(other.pendingInserts);
+            pendingRemoves = move(other.pendingRemoves);
+            viewValid = other.viewValid;
+            other.viewValid = false;
+        }
+        return *this;
+    }
+
+    /** Deep copy of the tree */
+    BST clone() const {
+        BST copy(countDuplicates);
+        copy.root = cloneTree(root);
+        if (filter) copy.filter.reset(new BloomFilter(*filter));
+        copy.removedSinceRebuild = removedSinceRebuild;
+        copy.sortedView = sortedView;
+        copy.pendingInserts = pendingInserts;
+        copy.pendingRemoves = pendingRemoves;
+        copy.viewValid = viewValid;
+        return copy;
+    }
 
     /** Task 2: Insert a node into the tree to form a balanced tree */
     void insert(int data) {
         root = insertRec(root, data);
+        noteChange(pendingInserts, data);
     }
 
     Node* insertRec(Node* node, int data) {
-        if (!node) return new Node(data);
+        if (!node) {
+            if (filter) filter->add(data);
+            return newNode(data);
+        }
+        if (countDuplicates && data == node->data) {
+            node->count++;
+            return node;
+        }
 
         if (data < node->data) {
             node->left = insertRec(node->left, data);
@@ -47,12 +122,27 @@ public:
         return node;
     }
 
+    /** A node from the tree's arena when it has one, from the heap otherwise */
+    Node* newNode(int data) {
+        if (arena) return new (arena->allocate()) Node(data);
+        return new Node(data);
+    }
+
+    void freeNode(Node* node) {
+        if (arena) {
+            arena->deallocate(node);
+        } else {
+            delete node;
+        }
+    }
+
     /** Function to balance the tree */
     void balance() {
-        vector<int> nodes;
-        storeInorder(root, nodes);
+        // Relink the existing nodes so occurrence counts survive and nothing is reallocated
+        vector<Node*> nodes;
+        storeInorderNodes(root, nodes);
         int n = nodes.size();
-        root = buildTree(nodes, 0, n - 1);
+        root = linkTree(nodes, 0, n - 1);
     }
 
     /** Store nodes of BST in sorted order */
@@ -63,19 +153,203 @@ public:
         storeInorder(node->right, nodes);
     }
 
-    /** Build balanced BST from sorted nodes */
-    Node* buildTree(vector<int>& nodes, int start, int end) {
+    /** Store the nodes themselves in sorted order */
+    void storeInorderNodes(Node* node, vector<Node*>& nodes) {
+        if (!node) return;
+        storeInorderNodes(node->left, nodes);
+        nodes.push_back(node);
+        storeInorderNodes(node->right, nodes);
+    }
+
+    /** Link sorted nodes into a balanced BST */
+    Node* linkTree(vector<Node*>& nodes, int start, int end) {
         if (start > end) return nullptr;
         int mid = (start + end) / 2;
-        Node* node = new Node(nodes[mid]);
-        node->left = buildTree(nodes, start, mid - 1);
-        node->right = buildTree(nodes, mid + 1, end);
+        Node* node = nodes[mid];
+        node->left = linkTree(nodes, start, mid - 1);
+        node->right = linkTree(nodes, mid + 1, end);
+        return node;
+    }
+
+    /** Build a balanced BST from unsorted keys: parallel sort and dedupe, then parallel build */
+    template <typename Range>
+    static BST fromUnsorted(const Range& keys) {
+        WorkStealingPool& pool = WorkStealingPool::shared();
+        vector<int> nodes(begin(keys), end(keys));
+        parallelSortUnique(pool, nodes);
+        return fromSorted(pool, nodes);
+    }
+
+    /** Build a balanced BST from a text file of keys: mapped, parsed and sorted in parallel */
+    static BST fromFile(const string& path) {
+        WorkStealingPool& pool = WorkStealingPool::shared();
+        vector<int> nodes = importKeys(path, pool);
+        return fromSorted(pool, nodes);
+    }
+
+    /**
+     * Build a balanced BST from sorted, distinct keys.
+     * The tree gets its own arena with one slot per key, in key order. Every slot is
+     * written by the one task that builds its subtree, so the workers never share an
+     * allocator, and the nodes are freed all at once with the tree.
+     */
+    static BST fromSorted(WorkStealingPool& pool, const vector<int>& nodes) {
+        BST tree;
+        tree.arena.reset(new NodeArena<Node>());
+        Node* slots = tree.arena->allocateBlock(nodes.size());
+        tree.root = buildTreeParallel(pool, nodes, slots, 0, nodes.size());
+        return tree;
+    }
+
+    /** Build balanced BST from sorted nodes in [start, end) into their slots, forking the two halves */
+    static Node* buildTreeParallel(WorkStealingPool& pool, const vector<int>& nodes, Node* slots,
+                                   size_t start, size_t end) {
+        if (start >= end) return nullptr;
+        size_t mid = start + (end - start) / 2;
+        Node* node = new (slots + mid) Node(nodes[mid]);
+        if (end - start <= ParallelSortCutoff) {
+            node->left = buildTreeParallel(pool, nodes, slots, start, mid);
+            node->right = buildTreeParallel(pool, nodes, slots, mid + 1, end);
+            return node;
+        }
+        TaskGroup group(pool);
+        group.run([&] { node->left = buildTreeParallel(pool, nodes, slots, start, mid); });
+        node->right = buildTreeParallel(pool, nodes, slots, mid + 1, end);
+        group.wait();
         return node;
     }
 
     /** Task 3: Remove a node from the tree */
     void remove(int data) {
+        Node* node = findNode(data);
+        if (!node) return;
+        noteChange(pendingRemoves, data);
+        // A counted key loses one occurrence before its node is unlinked
+        if (countDuplicates && node->count > 1) {
+            node->count--;
+            return;
+        }
         root = removeRec(root, data);
+        // A Bloom filter cannot forget a key; it is rebuilt once enough have gone
+        if (filter) removedSinceRebuild++;
+    }
+
+    /** Find the node holding data, or nullptr */
+    Node* findNode(int data) {
+        Node* current = root;
+        while (current && current->data != data) {
+            current = (data < current->data) ? current->left : current->right;
+        }
+        return current;
+    }
+
+    /** Number of copies of data in the tree; only above 1 when duplicates are counted */
+    int occurrences(int data) {
+        Node* node = findNode(data);
+        return node ? node->count : 0;
+    }
+
+    /**
+     * All keys in sorted order (a counted key repeated count times).
+     * The vector is kept between calls: a few inserts and removes since the last call are
+     * merged into it in one pass, and only after many changes is it rebuilt from the tree.
+     * Changes made by editing root directly are not seen.
+     */
+    const vector<int>& sortedKeys() {
+        if (!viewValid) {
+            rebuildView();
+        } else if (!pendingInserts.empty() || !pendingRemoves.empty()) {
+            patchView();
+        }
+        return sortedView;
+    }
+
+    /** Remember a change for the sorted view, or drop the view once too much has changed */
+    void noteChange(vector<int>& pending, int data) {
+        if (!viewValid) return;
+        pending.push_back(data);
+        if (pendingInserts.size() + pendingRemoves.size() > max<size_t>(64, sortedView.size() / 8)) {
+            viewValid = false;
+            pendingInserts.clear();
+            pendingRemoves.clear();
+        }
+    }
+
+    void rebuildView() {
+        sortedView.clear();
+        stack<Node*> path;
+        Node* current = root;
+        while (current || !path.empty()) {
+            while (current) {
+                path.push(current);
+                current = current->left;
+            }
+            current = path.top();
+            path.pop();
+            sortedView.insert(sortedView.end(), current->count, current->data);
+            current = current->right;
+        }
+        viewValid = true;
+    }
+
+    /** Merge the pending changes into the view; every pending remove matches a stored copy */
+    void patchView() {
+        sort(pendingInserts.begin(), pendingInserts.end());
+        sort(pendingRemoves.begin(), pendingRemoves.end());
+        vector<int> merged;
+        merged.reserve(sortedView.size() + pendingInserts.size());
+        size_t i = 0, j = 0, r = 0;
+        while (i < sortedView.size() || j < pendingInserts.size()) {
+            bool fromView = j == pendingInserts.size() || (i < sortedView.size() && sortedView[i] <= pendingInserts[j]);
+            int key = fromView ? sortedView[i++] : pendingInserts[j++];
+            if (r < pendingRemoves.size() && pendingRemoves[r] == key) {
+                r++;
+                continue;
+            }
+            merged.push_back(key);
+        }
+        sortedView.swap(merged);
+        pendingInserts.clear();
+        pendingRemoves.clear();
+    }
+
+    /** Search for a key, asking the Bloom filter first when there is one */
+    bool contains(int data) {
+        if (filter) {
+            refreshFilter();
+            if (!filter->mayContain(data)) return false;
+        }
+        Node* current = root;
+        while (current && current->data != data) {
+            current = (data < current->data) ? current->left : current->right;
+        }
+        if (!current && filter) filter->recordFalsePositive();
+        return current != nullptr;
+    }
+
+    /** Keep a Bloom filter in front of contains() so most misses skip the descent */
+    void enableFilter(size_t expectedKeys, double falsePositiveRate) {
+        vector<int> nodes;
+        storeInorder(root, nodes);
+        filter.reset(new BloomFilter(max(expectedKeys, nodes.size()), falsePositiveRate));
+        for (int key : nodes) filter->add(key);
+        removedSinceRebuild = 0;
+    }
+
+    void disableFilter() {
+        filter.reset();
+        removedSinceRebuild = 0;
+    }
+
+    /** Rebuild the filter once a quarter of its keys were removed or it outgrew its size */
+    void refreshFilter() {
+        bool stale = removedSinceRebuild * 4 > filter->keyCount();
+        bool overfull = filter->keyCount() > 2 * filter->capacity();
+        if (!stale && !overfull) return;
+        size_t live = filter->keyCount() - min(removedSinceRebuild, filter->keyCount());
+        unique_ptr<BloomFilter> old = move(filter);
+        enableFilter(max(old->capacity(), 2 * live), old->falsePositiveRate());
+        filter->carryStatsFrom(*old);
     }
 
     Node* removeRec(Node* node, int data) {
@@ -88,16 +362,17 @@ public:
         } else {
             if (!node->left) {
                 Node* temp = node->right;
-                delete node;
+                freeNode(node);
                 return temp;
             } else if (!node->right) {
                 Node* temp = node->left;
-                delete node;
+                freeNode(node);
                 return temp;
             }
 
             Node* temp = minValueNode(node->right);
             node->data = temp->data;
+            node->count = temp->count;
             node->right = removeRec(node->right, temp->data);
         }
         return node;
@@ -114,7 +389,7 @@ public:
     void inorderRec(Node* node) {
         if (!node) return;
         inorderRec(node->left);
-        cout << node->data << " ";
+        printKey(node);
         inorderRec(node->right);
     }
 
@@ -127,7 +402,7 @@ public:
     /** Helper function for pre-order traversal recursively */
     void preorderRec(Node* node) {
         if (!node) return;
-        cout << node->data << " ";
+        printKey(node);
         preorderRec(node->left);
         preorderRec(node->right);
     }
@@ -143,7 +418,7 @@ public:
         if (!node) return;
         postorderRec(node->left);
         postorderRec(node->right);
-        cout << node->data << " ";
+        printKey(node);
     }
 
     /** Task 6: Perform a post-order traversal */
@@ -159,7 +434,7 @@ public:
         q.push(node);
         while (!q.empty()) {
             Node* current = q.front();
-            cout << current->data << " ";
+            printKey(current);
             q.pop();
             if (current->left) q.push(current->left);
             if (current->right) q.push(current->right);
@@ -176,7 +451,7 @@ public:
     void bfsRec(queue<Node*> q) {
         if (q.empty()) return;
         Node* current = q.front();
-        cout << current->data << " ";
+        printKey(current);
         q.pop();
         if (current->left) q.push(current->left);
         if (current->right) q.push(current->right);
@@ -198,7 +473,7 @@ public:
         s.push(node);
         while (!s.empty()) {
             Node* current = s.top();
-            cout << current->data << " ";
+            printKey(current);
             s.pop();
             if (current->right) s.push(current->right);
             if (current->left) s.push(current->left);
@@ -214,7 +489,7 @@ public:
     /** Helper function for DFS traversal recursively */
     void dfsRec(Node* node) {
         if (!node) return;
-        cout << node->data << " ";
+        printKey(node);
         dfsRec(node->left);
         dfsRec(node->right);
     }
@@ -269,5 +544,40 @@ int main() {
     cout << "In-order Traversal after removing 3: ";
     balancedTree.inorder();
 
+    vector<int> unsortedKeys = {9, 3, 14, 1, 7, 3, 12, 5, 9, 11, 2};
+    BST loadedTree = BST::fromUnsorted(unsortedKeys);
+    cout << "Tree built from unsorted keys: \n";
+    printer.printTree(loadedTree.root);
+
+    cout << "In-order Traversal of built tree: ";
+    loadedTree.inorder();
+
+    const string keyFile = "Balanced.keys.txt";
+    {
+        ofstream out(keyFile);
+        out << "42\n17\n-5\n99\n17\n8\n";
+    }
+    BST fileTree = BST::fromFile(keyFile);
+    remove(keyFile.c_str());
+    cout << "In-order Traversal of tree loaded from " << keyFile << ": ";
+    fileTree.inorder();
+
+    loadedTree.sortedKeys();
+    loadedTree.insert(8);
+    loadedTree.remove(12);
+    cout << "Sorted view after inserting 8 and removing 12: ";
+    for (int key : loadedTree.sortedKeys()) cout << key << " ";
+    cout << endl;
+
+    loadedTree.enableFilter(1000, 0.01);
+    int misses = 0;
+    for (int key = 100; key < 10100; key++) {
+        if (!loadedTree.contains(key)) misses++;
+    }
+    BloomFilter::Stats stats = loadedTree.filter->stats();
+    cout << "Bloom filter: " << stats.bits << " bits, " << stats.hashes << " hashes, "
+         << stats.queries << " lookups, " << stats.definiteMisses << " answered by the filter, "
+         << stats.falsePositives << " false positives (" << misses << " misses total)\n";
+
     return 0;
 }
@@ -0,0 +1,111 @@
+#include <iostream>
+#include <chrono>
+#include <random>
+#include <vector>
+#include "BST.h"
+#include "BitmapSet.h"
+using namespace std;
+
+/**
+ * Hierarchical Bitmap Set
+ *
+ * When the keys come from a small range, one bit per possible key is cheaper than one
+ * node per key. A second level of bits says which 64-bit words of the first level have
+ * anything in them, a third level does the same for the second, and so on.
+ *
+ * Stick figure for the keys 3, 5 and 18 (8 bits per word to keep it small):
+ *
+ *   level 1:   [1 0 1 0 0 0 0 0]                  <- word 0 and word 2 are non-empty
+ *              /     \
+ *   level 0:   [00010100] [00000000] [00100000]    <- one bit per key, key 0 on the left
+ *
+ * In this figure:
+ * - A key is present if its bit in level 0 is set.
+ * - The successor of 5 is not in word 0, so the search looks up one level, finds the
+ *   next non-empty word (2) and takes its lowest bit: 18.
+ * - Every step is a mask plus one count-trailing-zeros instruction.
+ */
+
+/** Pointer tree used as a baseline */
+Node* insertPointer(Node* root, int data) {
+    Node** link = &root;
+    while (*link) {
+        link = (data < (*link)->data) ? &(*link)->left : &(*link)->right;
+    }
+    *link = new Node(data);
+    return root;
+}
+
+/** Smallest key greater than data, or -1 */
+int successorPointer(const Node* node, int data) {
+    int best = -1;
+    while (node) {
+        if (node->data > data) {
+            best = node->data;
+            node = node->left;
+        } else {
+            node = node->right;
+        }
+    }
+    return best;
+}
+
+template <typename F>
+long long timeMs(F f) {
+    auto start = chrono::steady_clock::now();
+    f();
+    return chrono::duration_cast<chrono::milliseconds>(chrono::steady_clock::now() - start).count();
+}
+
+int main() {
+    BitmapSet set(0, 199);
+    for (int key : {3, 5, 130, 64, 199, 0, 77}) {
+        set.insert(key);
+    }
+    cout << "In-order Traversal: ";
+    set.inorder();
+    cout << endl;
+
+    int next = 0, prev = 0;
+    set.successor(5, next);
+    set.predecessor(130, prev);
+    cout << "Successor of 5: " << next << ", predecessor of 130: " << prev << endl;
+    cout << "Keys below 100: " << set.rank(100) << endl;
+
+    set.remove(130);
+    cout << "In-order Traversal after removing 130: ";
+    set.inorder();
+    cout << endl;
+
+    const int universe = 1 << 24;
+    const int n = universe / 4;
+    mt19937 rng(11);
+    BitmapSet big(0, universe - 1);
+    Node* root = nullptr;
+    for (int i = 0; i < n; i++) {
+        int key = (int)(rng() % universe);
+        if (big.insert(key)) root = insertPointer(root, key);
+    }
+    vector<int> probes(n);
+    for (int& probe : probes) probe = (int)(rng() % universe);
+
+    long long sums[2] = {0, 0};
+    long long bitmapMs = timeMs([&] {
+        for (int probe : probes) {
+            int found = -1;
+            big.successor(probe, found);
+            sums[0] += found;
+        }
+    });
+    long long pointerMs = timeMs([&] {
+        for (int probe : probes) sums[1] += successorPointer(root, probe);
+    });
+
+    cout << "\n" << n << " successor queries over " << big.size() << " keys in [0, " << universe << "):\n";
+    cout << "Bitmap set:   " << bitmapMs << " ms, " << big.memoryBytes() / 1024 << " KB"
+         << (sums[0] == sums[1] ? "" : " (results differ!)") << "\n";
+    cout << "Pointer tree: " << pointerMs << " ms, " << big.size() * sizeof(Node) / 1024 << " KB\n";
+
+    destroyTree(root);
+    return 0;
+}
@@ -0,0 +1,237 @@
+//
+//  BitmapSet.h
+//  BinarySearchTrees
+//
+
+#ifndef BitmapSet_h
+#define BitmapSet_h
+
+#include <iostream>
+#include <cstdint>
+#include <stdexcept>
+#include <vector>
+
+using namespace std;
+
+// Ordered set of ints from a fixed range [minKey, maxKey], stored as a bitmap.
+// Level 0 has one bit per possible key. Every higher level has one bit per 64-bit
+// word of the level below, set when that word is non-zero, so an empty stretch of 64^k
+// keys is skipped by looking at a single bit. successor/predecessor climb until a word
+// has a set bit on the right side and then drop back down with tzcnt/lzcnt, which is a
+// handful of instructions per level.
+// rank() adds up whole 512-bit blocks with a Fenwick tree over the blocks' key counts,
+// which every insert and remove updates in O(log) steps, so writes and rank queries can
+// alternate freely. Memory is about 1.15 bits per possible key: the bitmap, the summary
+// levels and the Fenwick tree.
+class BitmapSet {
+public:
+    BitmapSet(int minKey, int maxKey) : base(minKey), count(0) {
+        if (maxKey < minKey) throw invalid_argument("BitmapSet: maxKey < minKey");
+        universe = (uint64_t)((int64_t)maxKey - (int64_t)minKey) + 1;
+        uint64_t bits = universe;
+        do {
+            uint64_t words = (bits + 63) / 64;
+            levels.push_back(vector<uint64_t>(words, 0));
+            bits = words;
+        } while (bits > 1);
+        blockCounts.assign((levels[0].size() + WordsPerBlock - 1) / WordsPerBlock + 1, 0);
+    }
+
+    /** Task 2: Insert a key */
+    bool insert(int key) {
+        uint64_t pos = index(key);
+        uint64_t& word = levels[0][pos >> 6];
+        uint64_t bit = 1ULL << (pos & 63);
+        if (word & bit) return false;
+        // Only a word that goes from empty to non-empty changes the level above
+        for (size_t l = 0; l < levels.size(); l++) {
+            uint64_t& w = levels[l][pos >> 6];
+            bool wasEmpty = (w == 0);
+            w |= 1ULL << (pos & 63);
+            if (!wasEmpty) break;
+            pos >>= 6;
+        }
+        count++;
+        addToBlock(index(key) >> 6, 1);
+        return true;
+    }
+
+    /** Task 3: Remove a key */
+    bool remove(int key) {
+        if (!inRange(key)) return false;
+        uint64_t pos = index(key);
+        if (!(levels[0][pos >> 6] & (1ULL << (pos & 63)))) return false;
+        // Only a word that becomes empty changes the level above
+        for (size_t l = 0; l < levels.size(); l++) {
+            uint64_t& w = levels[l][pos >> 6];
+            w &= ~(1ULL << (pos & 63));
+            if (w != 0) break;
+            pos >>= 6;
+        }
+        count--;
+        addToBlock(index(key) >> 6, -1);
+        return true;
+    }
+
+    /** Search for a key */
+    bool contains(int key) const {
+        if (!inRange(key)) return false;
+        uint64_t pos = index(key);
+        return (levels[0][pos >> 6] >> (pos & 63)) & 1;
+    }
+
+    /** Smallest key greater than key; returns false if there is none */
+    bool successor(int key, int& next) const {
+        int64_t start = (int64_t)key - base + 1;
+        if (start >= (int64_t)universe) return false;
+        if (start < 0) start = 0;
+        uint64_t pos = (uint64_t)start;
+        size_t l = 0;
+        // Climb until some word has a set bit at or after pos
+        while (true) {
+            uint64_t w = pos >> 6;
+            if (w >= levels[l].size()) return false;
+            uint64_t bits = levels[l][w] & (~0ULL << (pos & 63));
+            if (bits) {
+                pos = (w << 6) | (uint64_t)__builtin_ctzll(bits);
+                break;
+            }
+            if (l + 1 == levels.size()) return false;
+            pos = w + 1;
+            l++;
+        }
+        // Drop down taking the lowest set bit on each level
+        while (l > 0) {
+            l--;
+            pos = (pos << 6) | (uint64_t)__builtin_ctzll(levels[l][pos]);
+        }
+        next = keyAt(pos);
+        return true;
+    }
+
+    /** Largest key smaller than key; returns false if there is none */
+    bool predecessor(int key, int& prev) const {
+        int64_t start = (int64_t)key - base - 1;
+        if (start < 0) return false;
+        if (start >= (int64_t)universe) start = (int64_t)universe - 1;
+        uint64_t pos = (uint64_t)start;
+        size_t l = 0;
+        // Climb until some word has a set bit at or before pos
+        while (true) {
+            uint64_t w = pos >> 6;
+            uint64_t b = pos & 63;
+            uint64_t mask = (b == 63) ? ~0ULL : ((2ULL << b) - 1);
+            uint64_t bits = levels[l][w] & mask;
+            if (bits) {
+                pos = (w << 6) | (uint64_t)(63 - __builtin_clzll(bits));
+                break;
+            }
+            if (w == 0 || l + 1 == levels.size()) return false;
+            pos = w - 1;
+            l++;
+        }
+        // Drop down taking the highest set bit on each level
+        while (l > 0) {
+            l--;
+            pos = (pos << 6) | (uint64_t)(63 - __builtin_clzll(levels[l][pos]));
+        }
+        prev = keyAt(pos);
+        return true;
+    }
+
+    /** Number of keys smaller than key */
+    uint64_t rank(int key) const {
+        if ((int64_t)key <= (int64_t)base) return 0;
+        if ((int64_t)key - base >= (int64_t)universe) return count;
+        uint64_t pos = index(key);
+        uint64_t w = pos >> 6;
+        // Keys in the blocks before this one, then the words before w in this block
+        uint64_t result = 0;
+        for (uint64_t i = w / WordsPerBlock; i > 0; i &= i - 1) result += blockCounts[i];
+        for (uint64_t i = w - w % WordsPerBlock; i < w; i++) {
+            result += (uint64_t)__builtin_popcountll(levels[0][i]);
+        }
+        uint64_t below = (1ULL << (pos & 63)) - 1;
+        return result + (uint64_t)__builtin_popcountll(levels[0][w] & below);
+    }
+
+    bool min(int& key) const {
+        if (count == 0) return false;
+        if (contains(base)) {
+            key = base;
+            return true;
+        }
+        return successor(base, key);
+    }
+
+    bool max(int& key) const {
+        if (count == 0) return false;
+        int top = keyAt(universe - 1);
+        if (contains(top)) {
+            key = top;
+            return true;
+        }
+        return predecessor(top, key);
+    }
+
+    size_t size() const {
+        return count;
+    }
+
+    /** Bytes used by the bitmap levels and the Fenwick tree */
+    size_t memoryBytes() const {
+        size_t bytes = blockCounts.capacity() * sizeof(uint64_t);
+        for (const auto& level : levels) bytes += level.capacity() * sizeof(uint64_t);
+        return bytes;
+    }
+
+    /** Visit every key in increasing order */
+    template <typename F>
+    void forEach(F visit) const {
+        const vector<uint64_t>& bits = levels[0];
+        for (uint64_t w = 0; w < bits.size(); w++) {
+            uint64_t word = bits[w];
+            while (word) {
+                visit(keyAt((w << 6) | (uint64_t)__builtin_ctzll(word)));
+                word &= word - 1;
+            }
+        }
+    }
+
+    /** Task 4: Perform an in-order traversal */
+    void inorder() const {
+        forEach([](int key) { cout << key << " "; });
+        cout << endl;
+    }
+
+private:
+    static const uint64_t WordsPerBlock = 8; // one Fenwick entry per 512 bits
+
+    int base;
+    uint64_t universe;
+    size_t count;
+    vector<vector<uint64_t>> levels; // levels[0] is the bitmap itself
+    vector<uint64_t> blockCounts;    // Fenwick tree over the keys in each 512-bit block, 1-based
+
+    bool inRange(int key) const {
+        return (int64_t)key >= (int64_t)base && (int64_t)key - base < (int64_t)universe;
+    }
+
+    uint64_t index(int key) const {
+        if (!inRange(key)) throw out_of_range("BitmapSet: key outside the universe");
+        return (uint64_t)((int64_t)key - base);
+    }
+
+    int keyAt(uint64_t pos) const {
+        return (int)((int64_t)base + (int64_t)pos);
+    }
+
+    /** Add delta to the key count of the block holding word w */
+    void addToBlock(uint64_t w, int delta) {
+        for (uint64_t i = w / WordsPerBlock + 1; i < blockCounts.size(); i += i & (0 - i)) {
+            blockCounts[i] += (uint64_t)(int64_t)delta;
+        }
+    }
+};
+
+#endif /* BitmapSet_h */
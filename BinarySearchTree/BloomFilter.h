@@ -0,0 +1,156 @@
+//
+//  BloomFilter.h
+//  BinarySearchTrees
+//
+
+#ifndef BloomFilter_h
+#define BloomFilter_h
+
+#include <algorithm>
+#include <cmath>
+#include <cstdint>
+#include <vector>
+
+using namespace std;
+
+// Blocked Bloom filter for int keys.
+// Every key hashes to one 64-byte block (one cache line) and sets all of its bits
+// inside that block, so a lookup costs one cache miss instead of k. mayContain()
+// returning false means the key is definitely not in the set; true means "maybe",
+// with a false positive rate set at construction.
+class BloomFilter {
+public:
+    struct Stats {
+        size_t bits;
+        size_t hashes;
+        size_t keys;
+        size_t queries;
+        size_t definiteMisses;
+        size_t falsePositives;
+        double expectedFalsePositiveRate;
+    };
+
+    BloomFilter(size_t expectedKeys, double falsePositiveRate)
+        : planned(max<size_t>(expectedKeys, 1)), targetRate(falsePositiveRate), keys(0),
+          queries(0), definiteMisses(0), falsePositives(0) {
+        // Classic sizing: m = -n ln p / (ln 2)^2 bits and k = (m / n) ln 2 hashes
+        double p = min(max(falsePositiveRate, 1e-9), 0.5);
+        double bits = -(double)planned * log(p) / (log(2.0) * log(2.0));
+        size_t blockCount = max<size_t>(1, (size_t)ceil(bits / BlockBits));
+        blocks.assign(blockCount, Block());
+        k = (int)min(16.0, max(1.0, round(bits / planned * log(2.0))));
+    }
+
+    void add(int key) {
+        uint64_t h = mix((uint64_t)(uint32_t)key);
+        Block& block = blocks[blockIndex(h)];
+        uint64_t g = mix(h);
+        uint32_t h1 = (uint32_t)g;
+        uint32_t h2 = (uint32_t)(g >> 32) | 1;
+        for (int i = 0; i < k; i++) {
+            uint32_t bit = (h1 + i * h2) & (BlockBits - 1);
+            block.words[bit >> 6] |= 1ULL << (bit & 63);
+        }
+        keys++;
+    }
+
+    bool mayContain(int key) const {
+        queries++;
+        uint64_t h = mix((uint64_t)(uint32_t)key);
+        const Block& block = blocks[blockIndex(h)];
+        uint64_t g = mix(h);
+        uint32_t h1 = (uint32_t)g;
+        uint32_t h2 = (uint32_t)(g >> 32) | 1;
+        for (int i = 0; i < k; i++) {
+            uint32_t bit = (h1 + i * h2) & (BlockBits - 1);
+            if (!(block.words[bit >> 6] & (1ULL << (bit & 63)))) {
+                definiteMisses++;
+                return false;
+            }
+        }
+        return true;
+    }
+
+    // The owner calls this when the filter said "maybe" and the tree said no
+    void recordFalsePositive() const {
+        falsePositives++;
+    }
+
+    // Keep the query counters of a filter this one replaces
+    void carryStatsFrom(const BloomFilter& old) {
+        queries += old.queries;
+        definiteMisses += old.definiteMisses;
+        falsePositives += old.falsePositives;
+    }
+
+    void clear() {
+        fill(blocks.begin(), blocks.end(), Block());
+        keys = 0;
+    }
+
+    size_t keyCount() const {
+        return keys;
+    }
+
+    // Number of keys the filter was sized for
+    size_t capacity() const {
+        return planned;
+    }
+
+    double falsePositiveRate() const {
+        return targetRate;
+    }
+
+    // (1 - e^(-kn/m))^k for the keys added so far
+    double expectedFalsePositiveRate() const {
+        double m = (double)blocks.size() * BlockBits;
+        return pow(1.0 - exp(-(double)k * keys / m), k);
+    }
+
+    size_t memoryBytes() const {
+        return blocks.size() * sizeof(Block);
+    }
+
+    Stats stats() const {
+        Stats s;
+        s.bits = blocks.size() * BlockBits;
+        s.hashes = k;
+        s.keys = keys;
+        s.queries = queries;
+        s.definiteMisses = definiteMisses;
+        s.falsePositives = falsePositives;
+        s.expectedFalsePositiveRate = expectedFalsePositiveRate();
+        return s;
+    }
+
+private:
+    static const uint32_t BlockBits = 512;
+
+    struct alignas(64) Block {
+        uint64_t words[BlockBits / 64] = {};
+    };
+
+    vector<Block> blocks;
+    size_t planned;
+    double targetRate;
+    int k;
+    size_t keys;
+    mutable size_t queries;
+    mutable size_t definiteMisses;
+    mutable size_t falsePositives;
+
+    static uint64_t mix(uint64_t x) {
+        // splitmix64 finalizer
+        x += 0x9e3779b97f4a7c15ULL;
+        x = (x ^ (x >> 30)) * 0xbf58476d1ce4e5b9ULL;
+        x = (x ^ (x >> 27)) * 0x94d049bb133111ebULL;
+        return x ^ (x >> 31);
+    }
+
+    size_t blockIndex(uint64_t h) const {
+        // Maps the high 32 bits onto [0, blocks) without a division
+        return (size_t)(((h >> 32) * (uint64_t)blocks.size()) >> 32);
+    }
+};
+
+#endif /* BloomFilter_h */
@@ -34,6 +34,34 @@ public:
 
     BST() : root(nullptr) {}
 
+    ~BST() {
+        destroyTree(root);
+    }
+
+    // A copy would share nodes with this tree, use clone() for a deep copy
+    BST(const BST&) = delete;
+    BST& operator=(const BST&) = delete;
+
+    BST(BST&& other) noexcept : root(other.root) {
+        other.root = nullptr;
+    }
+
+    BST& operator=(BST&& other) noexcept {
+        if (this != &other) {
+            destroyTree(root);
+            root = other.root;
+            other.root = nullptr;
+        }
+        return *this;
+    }
+
+    /** Deep copy of the tree */
+    BST clone() const {
+        BST copy;
+        copy.root = cloneTree(root);
+        return copy;
+    }
+
     /** Task 2: Insert a node into the tree */
     void insert(int data) {
         if (!root) {
@@ -28,8 +28,38 @@ using namespace std;
 class BST {
 public:
     Node* root;
+    bool countDuplicates; // multiset mode: one node per key plus an occurrence count
 
-    BST() : root(nullptr) {}
+    explicit BST(bool countDuplicates = false) : root(nullptr), countDuplicates(countDuplicates) {}
+
+    ~BST() {
+        destroyTree(root);
+    }
+
+    // A copy would share nodes with this tree, use clone() for a deep copy
+    BST(const BST&) = delete;
+    BST& operator=(const BST&) = delete;
+
+    BST(BST&& other) noexcept : root(other.root), countDuplicates(other.countDuplicates) {
+        other.root = nullptr;
+    }
+
+    BST& operator=(BST&& other) noexcept {
+        if (this != &other) {
+            destroyTree(root);
+            root = other.root;
+            other.root = nullptr;
+            countDuplicates = other.countDuplicates;
+        }
+        return *this;
+    }
+
+    /** Deep copy of the tree */
+    BST clone() const {
+        BST copy(countDuplicates);
+        copy.root = cloneTree(root);
+        return copy;
+    }
 
     /** Task 2: Insert a node into the tree to form a degenerate tree */
     void insert(int data) {
@@ -38,6 +68,10 @@ public:
 
     Node* insertRec(Node* node, int data) {
         if (!node) return new Node(data);
+        if (countDuplicates && data == node->data) {
+            node->count++;
+            return node;
+        }
 
         if (data < node->data) {
             node->left = insertRec(node->left, data);
@@ -50,9 +84,32 @@ public:
 
     /** Task 3: Remove a node from the tree */
     void remove(int data) {
+        // A counted key loses one occurrence before its node is unlinked
+        if (countDuplicates) {
+            Node* node = findNode(data);
+            if (node && node->count > 1) {
+                node->count--;
+                return;
+            }
+        }
         root = removeRec(root, data);
     }
 
+    /** Find the node holding data, or nullptr */
+    Node* findNode(int data) {
+        Node* current = root;
+        while (current && current->data != data) {
+            current = (data < current->data) ? current->left : current->right;
+        }
+        return current;
+    }
+
+    /** Number of copies of data in the tree; only above 1 when duplicates are counted */
+    int occurrences(int data) {
+        Node* node = findNode(data);
+        return node ? node->count : 0;
+    }
+
     Node* removeRec(Node* node, int data) {
         if (!node) return nullptr;
 
@@ -73,6 +130,7 @@ public:
 
             Node* temp = minValueNode(node->right);
             node->data = temp->data;
+            node->count = temp->count;
             node->right = removeRec(node->right, temp->data);
         }
         return node;
@@ -89,7 +147,7 @@ public:
     void inorderRec(Node* node) {
         if (!node) return;
         inorderRec(node->left);
-        cout << node->data << " ";
+        printKey(node);
         inorderRec(node->right);
     }
 
@@ -102,7 +160,7 @@ public:
     /** Helper function for pre-order traversal recursively */
     void preorderRec(Node* node) {
         if (!node) return;
-        cout << node->data << " ";
+        printKey(node);
         preorderRec(node->left);
         preorderRec(node->right);
     }
@@ -118,7 +176,7 @@ public:
         if (!node) return;
         postorderRec(node->left);
         postorderRec(node->right);
-        cout << node->data << " ";
+        printKey(node);
     }
 
     /** Task 6: Perform a post-order traversal */
@@ -134,7 +192,7 @@ public:
         q.push(node);
         while (!q.empty()) {
             Node* current = q.front();
-            cout << current->data << " ";
+            printKey(current);
             q.pop();
             if (current->left) q.push(current->left);
             if (current->right) q.push(current->right);
@@ -151,7 +209,7 @@ public:
     void bfsRec(queue<Node*> q) {
         if (q.empty()) return;
         Node* current = q.front();
-        cout << current->data << " ";
+        printKey(current);
         q.pop();
         if (current->left) q.push(current->left);
         if (current->right) q.push(current->right);
@@ -173,7 +231,7 @@ public:
         s.push(node);
         while (!s.empty()) {
             Node* current = s.top();
-            cout << current->data << " ";
+            printKey(current);
             s.pop();
             if (current->right) s.push(current->right);
             if (current->left) s.push(current->left);
@@ -189,7 +247,7 @@ public:
     /** Helper function for DFS traversal recursively */
     void dfsRec(Node* node) {
         if (!node) return;
-        cout << node->data << " ";
+        printKey(node);
         dfsRec(node->left);
         dfsRec(node->right);
     }
@@ -235,6 +293,8 @@ int main() {
     cout << "DFS Recursive Traversal: ";
     degenerateTree.dfsRec();
 
+    BST copiedTree = degenerateTree.clone();
+
     degenerateTree.remove(3);
     cout << "Updated Tree w/Removed Node 3: \n";
     printer.printTree(degenerateTree.root);
@@ -242,5 +302,21 @@ int main() {
     cout << "In-order Traversal after removing 3: ";
     degenerateTree.inorder();
 
+    cout << "In-order Traversal of the copy made before removing 3: ";
+    copiedTree.inorder();
+
+    // Inserting the same key over and over builds the same chain as above.
+    // Counting duplicates keeps a single node and bumps its count instead.
+    BST countedTree(true);
+    for (int i = 0; i < 5; i++) countedTree.insert(7);
+    countedTree.insert(4);
+    cout << "Counted Tree after inserting 7 five times and 4 once: \n";
+    printer.printTree(countedTree.root);
+    cout << "In-order Traversal: ";
+    countedTree.inorder();
+
+    countedTree.remove(7);
+    cout << "Occurrences of 7 after removing it once: " << countedTree.occurrences(7) << endl;
+
     return 0;
 }
@@ -0,0 +1,89 @@
+#include <iostream>
+#include <chrono>
+#include <cstdio>
+#include <random>
+#include "DiskBPlusTree.h"
+using namespace std;
+
+/**
+ * Disk-Backed B+Tree
+ *
+ * Instead of one key per node, every node is a 4 KB page of a file holding hundreds of
+ * keys. Only internal pages steer the search; all keys live in the leaves, which are
+ * linked left to right.
+ *
+ * Stick figure of a tree with room for 3 keys per page:
+ *
+ *                    [ 20 | 40 ]
+ *                  /      |      \
+ *      [ 5 10 15 ] -> [ 20 30 ] -> [ 40 45 50 ]
+ *
+ * In this figure:
+ * - Keys below 20 are in the first leaf, keys from 20 to 39 in the second, and so on.
+ * - A full leaf splits in two and hands the first key of the new leaf to its parent.
+ * - A range scan finds its first leaf once and then follows the arrows.
+ * - Only a few pages are kept in memory at a time; the rest stays in the file.
+ */
+
+template <typename F>
+long long timeMs(F f) {
+    auto start = chrono::steady_clock::now();
+    f();
+    return chrono::duration_cast<chrono::milliseconds>(chrono::steady_clock::now() - start).count();
+}
+
+int main() {
+    const string path = "DiskBPlusTree.db";
+    remove(path.c_str());
+
+    {
+        DiskBPlusTree tree(path);
+        for (int key : {20, 5, 40, 10, 30, 45, 15, 50}) {
+            tree.insert(key);
+        }
+        cout << "In-order Traversal: ";
+        tree.inorder();
+        tree.remove(30);
+        cout << "In-order Traversal after removing 30: ";
+        tree.inorder();
+    }
+    {
+        DiskBPlusTree reopened(path);
+        cout << "Keys after reopening the file: ";
+        reopened.inorder();
+    }
+    remove(path.c_str());
+
+    // Two million keys behind a 1 MB buffer pool: the tree is about ten times larger
+    const int n = 2000000;
+    DiskBPlusTree big(path, 1 << 20);
+    mt19937 rng(6);
+    long long insertMs = timeMs([&] {
+        for (int i = 0; i < n; i++) big.insert((int)(rng() % 1000000000));
+    });
+    big.flush();
+
+    size_t found = 0;
+    long long lookupMs = timeMs([&] {
+        for (int i = 0; i < 100000; i++) found += big.contains((int)(rng() % 1000000000));
+    });
+    long long sum = 0;
+    size_t scanned = 0;
+    long long scanMs = timeMs([&] {
+        big.forEachInRange(0, 500000000, [&](int key) {
+            sum += key;
+            scanned++;
+        });
+    });
+
+    DiskBPlusTree::Stats stats = big.stats();
+    cout << "\n" << big.size() << " keys, height " << big.height() << ", file "
+         << big.fileBytes() / (1 << 20) << " MB, buffer pool " << big.cacheBytes() / (1 << 20) << " MB\n";
+    cout << "Insert:         " << insertMs << " ms\n";
+    cout << "100000 lookups: " << lookupMs << " ms (" << found << " hits)\n";
+    cout << "Range scan:     " << scanMs << " ms (" << scanned << " keys)\n";
+    cout << "Page hits " << stats.hits << ", misses " << stats.misses << ", writes " << stats.writes << "\n";
+
+    remove(path.c_str());
+    return 0;
+}
@@ -0,0 +1,480 @@
+//
+//  DiskBPlusTree.h
+//  BinarySearchTrees
+//
+
+#ifndef DiskBPlusTree_h
+#define DiskBPlusTree_h
+
+#include <iostream>
+#include <algorithm>
+#include <cerrno>
+#include <climits>
+#include <cstdint>
+#include <cstring>
+#include <stdexcept>
+#include <string>
+#include <unordered_map>
+#include <vector>
+#include <fcntl.h>
+#include <unistd.h>
+
+using namespace std;
+
+// B+tree of ints kept in fixed-size pages of a local file, for key sets larger than RAM.
+// Only a bounded number of pages live in memory at a time, in a buffer pool that evicts
+// with the CLOCK algorithm and writes dirty pages back on eviction or flush(). Internal
+// pages hold up to 509 separator keys, leaves up to 1020 keys plus a link to the next
+// leaf, so a billion keys are three or four page reads deep and range scans walk the
+// leaf chain, asking the OS to read the next leaf while the current one is processed.
+// remove() does not merge underfull leaves; separators stay valid without it and the
+// space is reused by later inserts into the same key range.
+// Single-threaded: the buffer pool is not locked.
+class DiskBPlusTree {
+public:
+    static constexpr size_t PageSize = 4096;
+
+    struct Stats {
+        size_t hits;      // page found in the buffer pool
+        size_t misses;    // page had to be read from the file
+        size_t writes;    // pages written back
+        size_t evictions; // frames reused for another page
+    };
+
+    // Opens the tree stored at path, or creates it. cacheBytes bounds the buffer pool.
+    DiskBPlusTree(const string& path, size_t cacheBytes = 64 << 20)
+        : clockHand(0), counters{0, 0, 0, 0} {
+        fd = ::open(path.c_str(), O_RDWR | O_CREAT, 0644);
+        if (fd < 0) throw runtime_error("DiskBPlusTree: cannot open " + path + ": " + strerror(errno));
+
+        size_t frameCount = max(cacheBytes / PageSize, MinFrames);
+        buffer.assign(frameCount * PageSize, 0);
+        frames.assign(frameCount, Frame());
+
+        try {
+            if (lseek(fd, 0, SEEK_END) == 0) {
+                meta = Meta{Magic, NoPage, 1, 0, 1};
+                meta.root = allocate(true).id();
+                writeMeta();
+            } else {
+                readRaw(0, &meta, sizeof(meta));
+                if (meta.magic != Magic) throw runtime_error("DiskBPlusTree: " + path + " is not a B+tree file");
+            }
+        } catch (...) {
+            ::close(fd);
+            throw;
+        }
+    }
+
+    ~DiskBPlusTree() {
+        try {
+            flush();
+        } catch (...) {
+            // a destructor cannot report the error; flush() explicitly to see it
+        }
+        ::close(fd);
+    }
+
+    //copying would share the file and the buffer pool
+    DiskBPlusTree(const DiskBPlusTree&) = delete;
+    DiskBPlusTree& operator=(const DiskBPlusTree&) = delete;
+
+    /** Task 2: Insert a key, returns false if it was already there */
+    bool insert(int key) {
+        Split split{false, 0, NoPage};
+        bool added = insert(meta.root, key, split);
+        if (split.happened) {
+            // The root split: a new root points at both halves
+            PageHandle root = allocate(false);
+            InternalPage* node = root.internal();
+            node->header.count = 1;
+            node->keys[0] = split.key;
+            node->children[0] = meta.root;
+            node->children[1] = split.right;
+            meta.root = root.id();
+            meta.height++;
+        }
+        if (added) meta.keyCount++;
+        return added;
+    }
+
+    /** Task 3: Remove a key, returns false if it was not there */
+    bool remove(int key) {
+        PageHandle page = findLeaf(key);
+        LeafPage* leaf = page.leaf();
+        int n = (int)leaf->header.count;
+        int pos = (int)(lower_bound(leaf->keys, leaf->keys + n, key) - leaf->keys);
+        if (pos == n || leaf->keys[pos] != key) return false;
+        memmove(leaf->keys + pos, leaf->keys + pos + 1, (n - pos - 1) * sizeof(int32_t));
+        leaf->header.count--;
+        page.markDirty();
+        meta.keyCount--;
+        return true;
+    }
+
+    /** Search for a key */
+    bool contains(int key) {
+        PageHandle page = findLeaf(key);
+        const LeafPage* leaf = page.leaf();
+        const int32_t* end = leaf->keys + leaf->header.count;
+        const int32_t* pos = lower_bound(leaf->keys, end, key);
+        return pos != end && *pos == key;
+    }
+
+    /** Visit every key in [lo, hi] in increasing order */
+    template <typename F>
+    void forEachInRange(int lo, int hi, F visit) {
+        if (lo > hi) return;
+        PageHandle page = findLeaf(lo);
+        while (true) {
+            const LeafPage* leaf = page.leaf();
+            PageId next = leaf->header.next;
+            if (next != NoPage) prefetch(next);
+            const int32_t* end = leaf->keys + leaf->header.count;
+            for (const int32_t* key = lower_bound(leaf->keys, end, lo); key != end; ++key) {
+                if (*key > hi) return;
+                visit((int)*key);
+            }
+            if (next == NoPage) return;
+            page = fetch(next);
+        }
+    }
+
+    /** Keys in [lo, hi] in sorted order */
+    vector<int> collect(int lo, int hi) {
+        vector<int> keys;
+        forEachInRange(lo, hi, [&](int key) { keys.push_back(key); });
+        return keys;
+    }
+
+    /** Task 4: Perform an in-order traversal */
+    void inorder() {
+        forEachInRange(INT_MIN, INT_MAX, [](int key) { cout << key << " "; });
+        cout << endl;
+    }
+
+    size_t size() const {
+        return meta.keyCount;
+    }
+
+    // Levels from the root to the leaves, 1 for a tree that is a single leaf
+    int height() const {
+        return (int)meta.height;
+    }
+
+    size_t fileBytes() const {
+        return (size_t)meta.pageCount * PageSize;
+    }
+
+    size_t cacheBytes() const {
+        return buffer.size();
+    }
+
+    Stats stats() const {
+        return counters;
+    }
+
+    /** Write every dirty page and the header, then ask the OS to make them durable */
+    void flush() {
+        for (size_t i = 0; i < frames.size(); i++) {
+            if (frames[i].dirty) writeBack(i);
+        }
+        writeMeta();
+        if (fsync(fd) != 0) throw runtime_error(string("DiskBPlusTree: fsync failed: ") + strerror(errno));
+    }
+
+private:
+    typedef uint32_t PageId;
+    static constexpr PageId NoPage = 0; // page 0 holds the header, so no node ever lives there
+    static constexpr uint64_t Magic = 0x31454552544250ULL; // "PBTREE1"
+    static constexpr size_t MinFrames = 16;
+
+    struct Meta {
+        uint64_t magic;
+        PageId root;
+        PageId pageCount;
+        uint64_t keyCount;
+        uint32_t height;
+    };
+
+    struct PageHeader {
+        uint32_t isLeaf;
+        uint32_t count;
+        PageId next; // leaves only: the leaf with the next larger keys
+        uint32_t unused;
+    };
+
+    static constexpr int LeafCapacity = (int)((PageSize - sizeof(PageHeader)) / sizeof(int32_t));
+    static constexpr int InternalCapacity =
+        (int)((PageSize - sizeof(PageHeader) - sizeof(PageId)) / (sizeof(int32_t) + sizeof(PageId)));
+
+    struct LeafPage {
+        PageHeader header;
+        int32_t keys[LeafCapacity];
+    };
+
+    // children[i] holds keys below keys[i], children[i + 1] keys from keys[i] up
+    struct InternalPage {
+        PageHeader header;
+        int32_t keys[InternalCapacity];
+        PageId children[InternalCapacity + 1];
+    };
+
+    static_assert(sizeof(LeafPage) <= PageSize, "leaf does not fit in a page");
+    static_assert(sizeof(InternalPage) <= PageSize, "internal node does not fit in a page");
+
+    struct Frame {
+        PageId id = NoPage; // NoPage marks an empty frame
+        int pins = 0;
+        bool dirty = false;
+        bool referenced = false;
+    };
+
+    // Keeps a page pinned in the buffer pool, so it cannot be evicted while in use
+    class PageHandle {
+    public:
+        PageHandle(DiskBPlusTree* tree, size_t frame) : tree(tree), frame(frame) {
+            tree->frames[frame].pins++;
+        }
+
+        ~PageHandle() {
+            if (tree) tree->frames[frame].pins--;
+        }
+
+        PageHandle(const PageHandle&) = delete;
+        PageHandle& operator=(const PageHandle&) = delete;
+
+        PageHandle(PageHandle&& other) noexcept : tree(other.tree), frame(other.frame) {
+            other.tree = nullptr;
+        }
+
+        PageHandle& operator=(PageHandle&& other) noexcept {
+            if (this != &other) {
+                if (tree) tree->frames[frame].pins--;
+                tree = other.tree;
+                frame = other.frame;
+                other.tree = nullptr;
+            }
+            return *this;
+        }
+
+        PageId id() const {
+            return tree->frames[frame].id;
+        }
+
+        void markDirty() {
+            tree->frames[frame].dirty = true;
+        }
+
+        bool isLeaf() const {
+            return reinterpret_cast<const PageHeader*>(data())->isLeaf != 0;
+        }
+
+        LeafPage* leaf() const {
+            return reinterpret_cast<LeafPage*>(data());
+        }
+
+        InternalPage* internal() const {
+            return reinterpret_cast<InternalPage*>(data());
+        }
+
+    private:
+        DiskBPlusTree* tree;
+        size_t frame;
+
+        char* data() const {
+            return &tree->buffer[frame * PageSize];
+        }
+    };
+
+    struct Split {
+        bool happened;
+        int key;       // smallest key of the new right page
+        PageId right;
+    };
+
+    int fd;
+    Meta meta;
+    vector<char> buffer; // frames.size() pages back to back
+    vector<Frame> frames;
+    unordered_map<PageId, size_t> frameOf;
+    size_t clockHand;
+    Stats counters;
+
+    bool insert(PageId id, int key, Split& split) {
+        PageHandle page = fetch(id);
+        if (page.isLeaf()) {
+            LeafPage* leaf = page.leaf();
+            int n = (int)leaf->header.count;
+            int pos = (int)(lower_bound(leaf->keys, leaf->keys + n, key) - leaf->keys);
+            if (pos < n && leaf->keys[pos] == key) return false;
+            page.markDirty();
+            if (n < LeafCapacity) {
+                memmove(leaf->keys + pos + 1, leaf->keys + pos, (n - pos) * sizeof(int32_t));
+                leaf->keys[pos] = key;
+                leaf->header.count++;
+                return true;
+            }
+            // Full: the upper half moves to a new leaf linked right after this one
+            vector<int32_t> keys(leaf->keys, leaf->keys + n);
+            keys.insert(keys.begin() + pos, key);
+            int half = (int)keys.size() / 2;
+            PageHandle right = allocate(true);
+            LeafPage* sibling = right.leaf();
+            copy(keys.begin(), keys.begin() + half, leaf->keys);
+            copy(keys.begin() + half, keys.end(), sibling->keys);
+            leaf->header.count = half;
+            sibling->header.count = (uint32_t)(keys.size() - half);
+            sibling->header.next = leaf->header.next;
+            leaf->header.next = right.id();
+            split = Split{true, sibling->keys[0], right.id()};
+            return true;
+        }
+
+        InternalPage* node = page.internal();
+        int n = (int)node->header.count;
+        int pos = (int)(upper_bound(node->keys, node->keys + n, key) - node->keys);
+        Split below{false, 0, NoPage};
+        bool added = insert(node->children[pos], key, below);
+        if (!below.happened) return added;
+
+        page.markDirty();
+        if (n < InternalCapacity) {
+            memmove(node->keys + pos + 1, node->keys + pos, (n - pos) * sizeof(int32_t));
+            memmove(node->children + pos + 2, node->children + pos + 1, (n - pos) * sizeof(PageId));
+            node->keys[pos] = below.key;
+            node->children[pos + 1] = below.right;
+            node->header.count++;
+            return added;
+        }
+        // Full: the middle key moves up, the keys after it move to a new node
+        vector<int32_t> keys(node->keys, node->keys + n);
+        vector<PageId> children(node->children, node->children + n + 1);
+        keys.insert(keys.begin() + pos, below.key);
+        children.insert(children.begin() + pos + 1, below.right);
+        int middle = (int)keys.size() / 2;
+        PageHandle right = allocate(false);
+        InternalPage* sibling = right.internal();
+        copy(keys.begin(), keys.begin() + middle, node->keys);
+        copy(children.begin(), children.begin() + middle + 1, node->children);
+        node->header.count = middle;
+        copy(keys.begin() + middle + 1, keys.end(), sibling->keys);
+        copy(children.begin() + middle + 1, children.end(), sibling->children);
+        sibling->header.count = (uint32_t)(keys.size() - middle - 1);
+        split = Split{true, keys[middle], right.id()};
+        return added;
+    }
+
+    PageHandle findLeaf(int key) {
+        PageHandle page = fetch(meta.root);
+        while (!page.isLeaf()) {
+            const InternalPage* node = page.internal();
+            int pos = (int)(upper_bound(node->keys, node->keys + node->header.count, key) - node->keys);
+            page = fetch(node->children[pos]);
+        }
+        return page;
+    }
+
+    PageHandle fetch(PageId id) {
+        auto found = frameOf.find(id);
+        if (found != frameOf.end()) {
+            counters.hits++;
+            frames[found->second].referenced = true;
+            return PageHandle(this, found->second);
+        }
+        counters.misses++;
+        size_t frame = victim();
+        readRaw((off_t)id * PageSize, &buffer[frame * PageSize], PageSize);
+        install(frame, id);
+        return PageHandle(this, frame);
+    }
+
+    PageHandle allocate(bool leaf) {
+        PageId id = meta.pageCount++;
+        size_t frame = victim();
+        memset(&buffer[frame * PageSize], 0, PageSize);
+        reinterpret_cast<PageHeader*>(&buffer[frame * PageSize])->isLeaf = leaf ? 1 : 0;
+        install(frame, id);
+        frames[frame].dirty = true;
+        return PageHandle(this, frame);
+    }
+
+    void install(size_t frame, PageId id) {
+        frames[frame].id = id;
+        frames[frame].dirty = false;
+        frames[frame].referenced = true;
+        frameOf[id] = frame;
+    }
+
+    // CLOCK: sweep the frames, giving every referenced page a second chance
+    size_t victim() {
+        for (size_t step = 0; step < 2 * frames.size() + 1; step++) {
+            size_t frame = clockHand;
+            clockHand = (clockHand + 1) % frames.size();
+            Frame& f = frames[frame];
+            if (f.id == NoPage) return frame;
+            if (f.pins > 0) continue;
+            if (f.referenced) {
+                f.referenced = false;
+                continue;
+            }
+            if (f.dirty) writeBack(frame);
+            frameOf.erase(f.id);
+            f.id = NoPage;
+            counters.evictions++;
+            return frame;
+        }
+        throw runtime_error("DiskBPlusTree: every page in the buffer pool is pinned");
+    }
+
+    void writeBack(size_t frame) {
+        writeRaw((off_t)frames[frame].id * PageSize, &buffer[frame * PageSize], PageSize);
+        frames[frame].dirty = false;
+        counters.writes++;
+    }
+
+    void writeMeta() {
+        vector<char> page(PageSize, 0);
+        memcpy(page.data(), &meta, sizeof(meta));
+        writeRaw(0, page.data(), PageSize);
+    }
+
+    // Ask the OS to start reading a page that is about to be needed
+    void prefetch(PageId id) {
+        if (frameOf.count(id)) return;
+#if defined(POSIX_FADV_WILLNEED)
+        posix_fadvise(fd, (off_t)id * PageSize, PageSize, POSIX_FADV_WILLNEED);
+#elif defined(F_RDADVISE)
+        struct radvisory advice;
+        advice.ra_offset = (off_t)id * PageSize;
+        advice.ra_count = (int)PageSize;
+        fcntl(fd, F_RDADVISE, &advice);
+#endif
+    }
+
+    void readRaw(off_t offset, void* data, size_t bytes) {
+        char* out = static_cast<char*>(data);
+        while (bytes > 0) {
+            ssize_t got = pread(fd, out, bytes, offset);
+            if (got < 0 && errno == EINTR) continue;
+            if (got <= 0) throw runtime_error(string("DiskBPlusTree: read failed: ") + (got < 0 ? strerror(errno) : "end of file"));
+            out += got;
+            offset += got;
+            bytes -= (size_t)got;
+        }
+    }
+
+    void writeRaw(off_t offset, const void* data, size_t bytes) {
+        const char* in = static_cast<const char*>(data);
+        while (bytes > 0) {
+            ssize_t put = pwrite(fd, in, bytes, offset);
+            if (put < 0 && errno == EINTR) continue;
+            if (put < 0) throw runtime_error(string("DiskBPlusTree: write failed: ") + strerror(errno));
+            in += put;
+            offset += put;
+            bytes -= (size_t)put;
+        }
+    }
+};
+
+#endif /* DiskBPlusTree_h */
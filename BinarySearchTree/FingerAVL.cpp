@@ -0,0 +1,81 @@
+#include <iostream>
+#include <chrono>
+#include <random>
+#include <vector>
+#include "FingerAVL.h"
+using namespace std;
+
+/**
+ * Finger Search
+ *
+ * A normal search starts at the root. A finger search starts at a node we already hold,
+ * usually the one touched last, and only walks up as far as it has to. Each node knows
+ * the two ancestors that bound its subtree, so the climb can tell where to stop.
+ *
+ * Stick figure, finger on `5`, looking for `7`:
+ *
+ *               8
+ *             /   \
+ *            4     12
+ *           / \
+ *          2   6
+ *             / \
+ *            5   7
+ *
+ * In this figure:
+ * - The subtree of `5` lies between its bounding ancestors `4` and `6`; 7 is outside,
+ *   so move up to `6`.
+ * - The subtree of `6` lies between `4` and `8`; 7 is inside, so `6` is the lowest common
+ *   ancestor of the finger and the key: descend 6 -> 7.
+ * - The closer the key is to the finger, the lower the climb stops. Only keys split by a
+ *   high node, like `7` and `12` by the root, still pay the full height.
+ * - Keys bigger than the maximum are hung off the cached maximum node directly.
+ */
+
+template <typename F>
+long long timeMs(F f) {
+    auto start = chrono::steady_clock::now();
+    f();
+    return chrono::duration_cast<chrono::milliseconds>(chrono::steady_clock::now() - start).count();
+}
+
+int main() {
+    FingerAVLTree tree;
+    for (int key : {8, 4, 12, 2, 6, 5, 7}) {
+        tree.insert(key);
+    }
+    cout << "In-order Traversal: ";
+    tree.inorder();
+    FingerAVLTree::Finger five = tree.find(nullptr, 5);
+    cout << "Found 7 from the finger on 5: " << (tree.find(five, 7) ? "yes" : "no") << endl;
+    tree.remove(4);
+    cout << "In-order Traversal after removing 4: ";
+    tree.inorder();
+
+    // Nearly sorted stream: every key is within 64 of its position
+    const int n = 2000000;
+    mt19937 rng(14);
+    vector<int> keys(n);
+    for (int i = 0; i < n; i++) keys[i] = i * 4 + (int)(rng() % 256);
+
+    FingerAVLTree withFinger, fromRoot;
+    long long fingerInsertMs = timeMs([&] {
+        for (int key : keys) withFinger.insert(key);
+    });
+    long long fingerLookupMs = timeMs([&] {
+        for (int key : keys) withFinger.contains(key + 1);
+    });
+    long long rootInsertMs = timeMs([&] {
+        for (int key : keys) fromRoot.insert(nullptr, key);
+    });
+    long long rootLookupMs = timeMs([&] {
+        for (int key : keys) fromRoot.find(nullptr, key + 1);
+    });
+
+    cout << "\n" << n << " nearly sorted inserts and lookups:\n";
+    cout << "Finger from the last key: " << fingerInsertMs << " ms inserting, " << fingerLookupMs
+         << " ms looking up, " << (double)withFinger.stepsTaken() / (2.0 * n) << " nodes visited per operation\n";
+    cout << "Search from the root:     " << rootInsertMs << " ms inserting, " << rootLookupMs
+         << " ms looking up, " << (double)fromRoot.stepsTaken() / (2.0 * n) << " nodes visited per operation\n";
+    return 0;
+}
@@ -0,0 +1,392 @@
+//
+//  FingerAVL.h
+//  BinarySearchTrees
+//
+
+#ifndef FingerAVL_h
+#define FingerAVL_h
+
+#include <iostream>
+#include <algorithm>
+#include <utility>
+#include <vector>
+
+using namespace std;
+
+// AVL tree with parent pointers and finger search.
+// A finger is a node a search starts from instead of the root. Every node also points at
+// the two ancestors that bound its subtree (the nearest one it lies left of and the
+// nearest one it lies right of), so find(hint, key) and insert(hint, key) can tell at each
+// node whether the key is inside its subtree. The climb from the hint stops at the lowest
+// common ancestor of the hint and the key, and the descent starts there. For keys d apart
+// that is O(log d) steps, unless a node high above both separates them, as the root does
+// for its own neighbours. The plain insert(key)/contains(key) use the last node touched as
+// their finger, and keys past the cached min or max go straight to that end.
+// A rotation changes the bounds of the two nodes it turns and nothing else, so keeping them
+// costs O(1) per rotation; a remove() also rebinds one spine below the removed node.
+// Rebalancing walks up from the change and stops as soon as a height stays the same.
+// A finger is only valid until the next remove(), which may free or reuse its node.
+class FingerAVLTree {
+public:
+    struct Node {
+        int key;
+        int height;
+        Node* left;
+        Node* right;
+        Node* parent;
+        Node* low;  // nearest ancestor the subtree lies right of, nullptr if none
+        Node* high; // nearest ancestor the subtree lies left of, nullptr if none
+        Node(int k, Node* p)
+            : key(k), height(1), left(nullptr), right(nullptr), parent(p), low(nullptr), high(nullptr) {}
+    };
+
+    typedef const Node* Finger;
+
+    Node* root;
+
+    FingerAVLTree() : root(nullptr), minNode(nullptr), maxNode(nullptr), last(nullptr), count(0), steps(0) {}
+
+    ~FingerAVLTree() {
+        destroyTree(root);
+    }
+
+    //copying would share nodes between two trees, use clone() for a deep copy
+    FingerAVLTree(const FingerAVLTree&) = delete;
+    FingerAVLTree& operator=(const FingerAVLTree&) = delete;
+
+    FingerAVLTree(FingerAVLTree&& other) noexcept
+        : root(other.root), minNode(other.minNode), maxNode(other.maxNode), last(other.last),
+          count(other.count), steps(other.steps) {
+        other.forget();
+    }
+
+    FingerAVLTree& operator=(FingerAVLTree&& other) noexcept {
+        if (this != &other) {
+            destroyTree(root);
+            root = other.root;
+            minNode = other.minNode;
+            maxNode = other.maxNode;
+            last = other.last;
+            count = other.count;
+            steps = other.steps;
+            other.forget();
+        }
+        return *this;
+    }
+
+    //deep copy of the tree; fingers into this tree do not carry over
+    FingerAVLTree clone() const {
+        FingerAVLTree copy;
+        copy.root = cloneTree(root);
+        copy.count = count;
+        copy.minNode = copy.extreme(false);
+        copy.maxNode = copy.extreme(true);
+        return copy;
+    }
+
+    //insert starting from the last node touched
+    Finger insert(int key) {
+        return insert(last, key);
+    }
+
+    //insert starting from hint (the root if null); returns the key's node
+    Finger insert(Finger hint, int key) {
+        if (!root) {
+            root = minNode = maxNode = last = new Node(key, nullptr);
+            count = 1;
+            return root;
+        }
+        Node* parent;
+        if (key > maxNode->key) {
+            parent = maxNode;
+        } else if (key < minNode->key) {
+            parent = minNode;
+        } else {
+            parent = descend(climb(mutableNode(hint), key), key);
+            if (parent->key == key) return last = parent;
+        }
+
+        Node* node = new Node(key, parent);
+        if (key < parent->key) {
+            parent->left = node;
+            node->low = parent->low;
+            node->high = parent;
+        } else {
+            parent->right = node;
+            node->low = parent;
+            node->high = parent->high;
+        }
+        count++;
+        if (key > maxNode->key) maxNode = node;
+        if (key < minNode->key) minNode = node;
+        fixAfterInsert(node);
+        return last = node;
+    }
+
+    //search starting from hint (the root if null); returns the key's node or nullptr
+    Finger find(Finger hint, int key) {
+        if (!root || key < minNode->key || key > maxNode->key) return nullptr;
+        Node* node = descend(climb(mutableNode(hint), key), key);
+        last = node;
+        return node->key == key ? node : nullptr;
+    }
+
+    //search starting from the last node touched
+    bool contains(int key) {
+        return find(last, key) != nullptr;
+    }
+
+    //remove a key, returns false if it was not there
+    bool remove(int key) {
+        if (!root) return false;
+        Node* node = descend(climb(last, key), key);
+        if (node->key != key) return false;
+
+        // A node with two children trades places with its successor, which has at most one
+        if (node->left && node->right) {
+            Node* successor = node->right;
+            while (successor->left) successor = successor->left;
+            node->key = successor->key;
+            node = successor;
+        }
+        Node* child = node->left ? node->left : node->right;
+        Node* parent = node->parent;
+        if (child) child->parent = parent;
+        // The child's subtree was bounded by node on one side along one spine; it now
+        // inherits node's bound on that side
+        if (child == node->right) {
+            for (Node* spine = child; spine; spine = spine->left) spine->low = node->low;
+        } else {
+            for (Node* spine = child; spine; spine = spine->right) spine->high = node->high;
+        }
+        replaceChild(parent, node, child);
+        delete node;
+        count--;
+
+        fixAfterRemove(parent);
+        minNode = extreme(false);
+        maxNode = extreme(true);
+        last = parent ? parent : root;
+        return true;
+    }
+
+    Finger lastFinger() const {
+        return last;
+    }
+
+    Finger minimum() const {
+        return minNode;
+    }
+
+    Finger maximum() const {
+        return maxNode;
+    }
+
+    size_t size() const {
+        return count;
+    }
+
+    // Nodes visited by searches so far, to compare fingers with starting at the root
+    size_t stepsTaken() const {
+        return steps;
+    }
+
+    //inorder traversal
+    void inorder() const {
+        vector<const Node*> path;
+        const Node* node = root;
+        while (node || !path.empty()) {
+            while (node) {
+                path.push_back(node);
+                node = node->left;
+            }
+            node = path.back();
+            path.pop_back();
+            cout << node->key << " ";
+            node = node->right;
+        }
+        cout << endl;
+    }
+
+private:
+    Node* minNode;
+    Node* maxNode;
+    Node* last; // finger used when the caller gives none
+    size_t count;
+    size_t steps;
+
+    void forget() {
+        root = minNode = maxNode = last = nullptr;
+        count = 0;
+    }
+
+    // Fingers are handed out as const; the tree owns the nodes, so it may change them
+    Node* mutableNode(Finger finger) const {
+        return const_cast<Node*>(finger);
+    }
+
+    static int height(const Node* node) {
+        return node ? node->height : 0;
+    }
+
+    static void update(Node* node) {
+        node->height = max(height(node->left), height(node->right)) + 1;
+    }
+
+    //whether key falls inside node's subtree, going by its bounding ancestors
+    static bool covers(const Node* node, int key) {
+        return (!node->low || node->low->key < key) && (!node->high || key < node->high->key);
+    }
+
+    //go up from the finger to the lowest ancestor whose subtree holds key
+    Node* climb(Node* node, int key) {
+        if (!node) return root;
+        while (!covers(node, key)) {
+            node = node->parent;
+            steps++;
+        }
+        return node;
+    }
+
+    //ordinary descent; returns the key's node or the node it would hang from
+    Node* descend(Node* node, int key) {
+        while (true) {
+            steps++;
+            Node* next = (key < node->key) ? node->left : (key > node->key) ? node->right : nullptr;
+            if (!next) return node;
+            node = next;
+        }
+    }
+
+    Node* extreme(bool rightmost) const {
+        Node* node = root;
+        while (node && (rightmost ? node->right : node->left)) node = rightmost ? node->right : node->left;
+        return node;
+    }
+
+    void replaceChild(Node* parent, Node* oldChild, Node* newChild) {
+        if (!parent) {
+            root = newChild;
+        } else if (parent->left == oldChild) {
+            parent->left = newChild;
+        } else {
+            parent->right = newChild;
+        }
+    }
+
+    Node* rightRotate(Node* y) {
+        Node* x = y->left;
+        y->left = x->right;
+        if (x->right) x->right->parent = y;
+        x->parent = y->parent;
+        replaceChild(y->parent, y, x);
+        x->right = y;
+        y->parent = x;
+        x->low = y->low;
+        x->high = y->high;
+        y->low = x;
+        update(y);
+        update(x);
+        return x;
+    }
+
+    Node* leftRotate(Node* x) {
+        Node* y = x->right;
+        x->right = y->left;
+        if (y->left) y->left->parent = x;
+        y->parent = x->parent;
+        replaceChild(x->parent, x, y);
+        y->left = x;
+        x->parent = y;
+        y->low = x->low;
+        y->high = x->high;
+        x->high = y;
+        update(x);
+        update(y);
+        return y;
+    }
+
+    //restore the AVL shape at node, returns the node now at its place
+    Node* rebalance(Node* node) {
+        int balance = height(node->left) - height(node->right);
+        if (balance > 1) {
+            if (height(node->left->left) < height(node->left->right)) leftRotate(node->left);
+            return rightRotate(node);
+        }
+        if (balance < -1) {
+            if (height(node->right->right) < height(node->right->left)) rightRotate(node->right);
+            return leftRotate(node);
+        }
+        return node;
+    }
+
+    //after an insert one rotation restores the old height, so the walk stops there
+    void fixAfterInsert(Node* node) {
+        for (Node* current = node->parent; current; current = current->parent) {
+            int before = current->height;
+            update(current);
+            int balance = height(current->left) - height(current->right);
+            if (balance > 1 || balance < -1) {
+                rebalance(current);
+                return;
+            }
+            if (current->height == before) return;
+        }
+    }
+
+    //after a remove rotations can shrink a subtree, so the walk goes on until a height holds
+    void fixAfterRemove(Node* node) {
+        while (node) {
+            int before = node->height;
+            update(node);
+            Node* top = rebalance(node);
+            if (top->height == before) return;
+            node = top->parent;
+        }
+    }
+
+    void destroyTree(Node* node) {
+        while (node) {
+            if (node->left) {
+                Node* left = node->left;
+                node->left = left->right;
+                left->right = node;
+                node = left;
+            } else {
+                Node* right = node->right;
+                delete node;
+                node = right;
+            }
+        }
+    }
+
+    Node* cloneTree(const Node* source) const {
+        if (!source) return nullptr;
+        Node* copy = new Node(source->key, nullptr);
+        copy->height = source->height;
+        vector<pair<const Node*, Node*>> pending;
+        pending.push_back(make_pair(source, copy));
+        while (!pending.empty()) {
+            const Node* from = pending.back().first;
+            Node* to = pending.back().second;
+            pending.pop_back();
+            if (from->left) {
+                to->left = new Node(from->left->key, to);
+                to->left->height = from->left->height;
+                to->left->low = to->low;
+                to->left->high = to;
+                pending.push_back(make_pair(from->left, to->left));
+            }
+            if (from->right) {
+                to->right = new Node(from->right->key, to);
+                to->right->height = from->right->height;
+                to->right->low = to;
+                to->right->high = to->high;
+                pending.push_back(make_pair(from->right, to->right));
+            }
+        }
+        return copy;
+    }
+};
+
+#endif /* FingerAVL_h */
@@ -30,12 +30,19 @@ using namespace std;
 class BST {
 public:
     Node* root;
+    bool countDuplicates; // multiset mode: one node per key plus an occurrence count
 
     /** Helper function to insert a node recursively */
     Node* insertRec(Node* node, int data) {
         // Step: If the node is null, create a new node
         if (!node) return new Node(data);
 
+        // Step: When duplicates are counted, an equal key only bumps the count
+        if (countDuplicates && data == node->data) {
+            node->count++;
+            return node;
+        }
+
         // Step: Otherwise, recurse down the tree
         if (data < node->data)
             node->left = insertRec(node->left, data);
@@ -70,6 +77,7 @@ public:
             // Step: Node with two children, get the inorder successor (smallest in the right subtree)
             Node* temp = minValueNode(node->right);
             node->data = temp->data;
+            node->count = temp->count;
             node->right = removeRec(node->right, temp->data);
         }
         return node;
@@ -88,14 +96,14 @@ public:
     void inorderRec(Node* node) {
         if (!node) return;
         inorderRec(node->left);
-        cout << node->data << " ";
+        printKey(node);
         inorderRec(node->right);
     }
 
     /** Helper function for pre-order traversal recursively */
     void preorderRec(Node* node) {
         if (!node) return;
-        cout << node->data << " ";
+        printKey(node);
         preorderRec(node->left);
         preorderRec(node->right);
     }
@@ -105,7 +113,7 @@ public:
         if (!node) return;
         postorderRec(node->left);
         postorderRec(node->right);
-        cout << node->data << " ";
+        printKey(node);
     }
 
     /** Helper function for BFS traversal iteratively */
@@ -115,7 +123,7 @@ public:
         q.push(node);
         while (!q.empty()) {
             Node* current = q.front();
-            cout << current->data << " ";
+            printKey(current);
             q.pop();
             if (current->left) q.push(current->left);
             if (current->right) q.push(current->right);
@@ -129,7 +137,7 @@ public:
         s.push(node);
         while (!s.empty()) {
             Node* current = s.top();
-            cout << current->data << " ";
+            printKey(current);
             s.pop();
             if (current->right) s.push(current->right);
             if (current->left) s.push(current->left);
@@ -140,7 +148,7 @@ public:
     void bfsRec(queue<Node*> q) {
         if (q.empty()) return;
         Node* current = q.front();
-        cout << current->data << " ";
+        printKey(current);
         q.pop();
         if (current->left) q.push(current->left);
         if (current->right) q.push(current->right);
@@ -150,13 +158,42 @@ public:
     /** Helper function for DFS traversal recursively */
     void dfsRec(Node* node) {
         if (!node) return;
-        cout << node->data << " ";
+        printKey(node);
         dfsRec(node->left);
         dfsRec(node->right);
     }
 
 public:
-    BST() : root(nullptr) {}
+    explicit BST(bool countDuplicates = false) : root(nullptr), countDuplicates(countDuplicates) {}
+
+    ~BST() {
+        destroyTree(root);
+    }
+
+    // A copy would share nodes with this tree, use clone() for a deep copy
+    BST(const BST&) = delete;
+    BST& operator=(const BST&) = delete;
+
+    BST(BST&& other) noexcept : root(other.root), countDuplicates(other.countDuplicates) {
+        other.root = nullptr;
+    }
+
+    BST& operator=(BST&& other) noexcept {
+        if (this != &other) {
+            destroyTree(root);
+            root = other.root;
+            other.root = nullptr;
+            countDuplicates = other.countDuplicates;
+        }
+        return *this;
+    }
+
+    /** Deep copy of the tree */
+    BST clone() const {
+        BST copy(countDuplicates);
+        copy.root = cloneTree(root);
+        return copy;
+    }
 
     /** Task 2: Insert a node into the tree */
     void insert(int data) {
@@ -165,9 +202,32 @@ public:
 
     /** Task 3: Remove a node from the tree */
     void remove(int data) {
+        // A counted key loses one occurrence before its node is unlinked
+        if (countDuplicates) {
+            Node* node = findNode(data);
+            if (node && node->count > 1) {
+                node->count--;
+                return;
+            }
+        }
         root = removeRec(root, data);
     }
 
+    /** Find the node holding data, or nullptr */
+    Node* findNode(int data) {
+        Node* current = root;
+        while (current && current->data != data) {
+            current = (data < current->data) ? current->left : current->right;
+        }
+        return current;
+    }
+
+    /** Number of copies of data in the tree; only above 1 when duplicates are counted */
+    int occurrences(int data) {
+        Node* node = findNode(data);
+        return node ? node->count : 0;
+    }
+
     /** Task 4: Perform an in-order traversal */
     void inorder() {
         inorderRec(root);
@@ -0,0 +1,115 @@
+#include <iostream>
+#include <chrono>
+#include <random>
+#include <vector>
+#include "BST.h"
+#include "IndexedBST.h"
+using namespace std;
+
+/**
+ * Index-Based Binary Search Tree
+ *
+ * Instead of allocating every node on its own, all nodes sit in one array and a child
+ * is stored as its position in that array.
+ *
+ *   pool:  [0]       [1]       [2]       [3]
+ *          40,1,2    20,3,-    60,-,-    10,-,-
+ *
+ *          40            <- pool[0]
+ *         /  \
+ *       20    60         <- pool[1], pool[2]
+ *       /
+ *     10                 <- pool[3]
+ *
+ * In this figure:
+ * - Each entry is key, left index, right index; `-` means no child.
+ * - A 32-bit index is half the size of a pointer, so a node shrinks from 24 to 12 bytes.
+ * - The whole tree is one block of memory, so it is cheap to copy or save.
+ */
+
+/** Pointer tree used as the baseline */
+Node* insertPointer(Node* root, int data) {
+    Node** link = &root;
+    while (*link) {
+        link = (data < (*link)->data) ? &(*link)->left : &(*link)->right;
+    }
+    *link = new Node(data);
+    return root;
+}
+
+bool containsPointer(Node* node, int data) {
+    while (node) {
+        if (data == node->data) return true;
+        node = (data < node->data) ? node->left : node->right;
+    }
+    return false;
+}
+
+template <typename F>
+long long timeMs(F f) {
+    auto start = chrono::steady_clock::now();
+    f();
+    return chrono::duration_cast<chrono::milliseconds>(chrono::steady_clock::now() - start).count();
+}
+
+int main() {
+    IndexedBST<> small;
+    for (int key : {40, 20, 60, 10, 30, 50, 70}) small.insert(key);
+    cout << "Index-Based BST:\n";
+    cout << "In-order Traversal: ";
+    small.inorder();
+    cout << "Pre-order Traversal: ";
+    small.preorder();
+    cout << "Post-order Traversal: ";
+    small.postorder();
+    cout << "BFS Iterative Traversal: ";
+    small.bfsIter();
+    small.remove(20);
+    cout << "In-order Traversal after removing 20: ";
+    small.inorder();
+
+    const int n = 2000000;
+    mt19937 rng(7);
+    vector<int> keys(n);
+    for (int& key : keys) key = (int)(rng() % 100000000);
+    vector<int> probes(n);
+    for (int& probe : probes) probe = (int)(rng() % 100000000);
+
+    Node* pointerRoot = nullptr;
+    IndexedBST<uint32_t> compact;
+    IndexedBST<uint64_t> wide;
+    compact.reserve(n);
+    wide.reserve(n);
+    for (int key : keys) {
+        pointerRoot = insertPointer(pointerRoot, key);
+        compact.insert(key);
+        wide.insert(key);
+    }
+
+    cout << "\nMemory for " << n << " nodes:\n";
+    cout << "Pointer nodes:   " << sizeof(Node) << " bytes each, "
+         << (size_t)n * sizeof(Node) / (1 << 20) << " MB\n";
+    cout << "32-bit indices:  " << sizeof(IndexedBST<uint32_t>::Node) << " bytes each, "
+         << compact.memoryBytes() / (1 << 20) << " MB\n";
+    cout << "64-bit indices:  " << sizeof(IndexedBST<uint64_t>::Node) << " bytes each, "
+         << wide.memoryBytes() / (1 << 20) << " MB\n";
+
+    size_t hits[3] = {0, 0, 0};
+    long long pointerMs = timeMs([&] {
+        for (int probe : probes) hits[0] += containsPointer(pointerRoot, probe);
+    });
+    long long compactMs = timeMs([&] {
+        for (int probe : probes) hits[1] += compact.contains(probe);
+    });
+    long long wideMs = timeMs([&] {
+        for (int probe : probes) hits[2] += wide.contains(probe);
+    });
+
+    cout << "\nLookups of " << n << " random keys:\n";
+    cout << "Pointer nodes:   " << pointerMs << " ms (" << hits[0] << " hits)\n";
+    cout << "32-bit indices:  " << compactMs << " ms (" << hits[1] << " hits)\n";
+    cout << "64-bit indices:  " << wideMs << " ms (" << hits[2] << " hits)\n";
+
+    destroyTree(pointerRoot);
+    return 0;
+}
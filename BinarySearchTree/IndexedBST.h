@@ -0,0 +1,207 @@
+//
+//  IndexedBST.h
+//  BinarySearchTrees
+//
+
+#ifndef IndexedBST_h
+#define IndexedBST_h
+
+#include <iostream>
+#include <cstdint>
+#include <limits>
+#include <queue>
+#include <stack>
+#include <stdexcept>
+#include <vector>
+
+using namespace std;
+
+// Binary search tree whose nodes live in one vector and point at their children by
+// index instead of by pointer. With the default 32-bit Index a node is 12 bytes
+// instead of 24, so twice as many nodes fit in each cache line. Use a 64-bit Index
+// for trees with more than 4G nodes. Removed slots are reused through a free list.
+template <typename Index = uint32_t>
+class IndexedBST {
+public:
+    struct Node {
+        int data;
+        Index left;
+        Index right;
+    };
+
+    static constexpr Index Null = numeric_limits<Index>::max();
+
+    IndexedBST() : root(Null), freeList(Null), count(0) {}
+
+    /** Task 2: Insert a node into the tree */
+    void insert(int data) {
+        Index created = allocate(data);
+        Index* link = &root;
+        while (*link != Null) {
+            Node& node = pool[*link];
+            link = (data < node.data) ? &node.left : &node.right;
+        }
+        *link = created;
+    }
+
+    /** Task 3: Remove a node from the tree */
+    void remove(int data) {
+        Index* link = &root;
+        while (*link != Null && pool[*link].data != data) {
+            Node& node = pool[*link];
+            link = (data < node.data) ? &node.left : &node.right;
+        }
+        if (*link == Null) return;
+
+        Index target = *link;
+        Node& node = pool[target];
+        if (node.left == Null) {
+            *link = node.right;
+            release(target);
+        } else if (node.right == Null) {
+            *link = node.left;
+            release(target);
+        } else {
+            // Two children: move the in-order successor's key up and unlink it
+            Index* successorLink = &node.right;
+            while (pool[*successorLink].left != Null) {
+                successorLink = &pool[*successorLink].left;
+            }
+            Index successor = *successorLink;
+            node.data = pool[successor].data;
+            *successorLink = pool[successor].right;
+            release(successor);
+        }
+    }
+
+    /** Search for a key */
+    bool contains(int data) const {
+        Index current = root;
+        while (current != Null) {
+            const Node& node = pool[current];
+            if (data == node.data) return true;
+            current = (data < node.data) ? node.left : node.right;
+        }
+        return false;
+    }
+
+    /** Reserve room for n nodes so the pool does not grow during inserts */
+    void reserve(size_t n) {
+        pool.reserve(n);
+    }
+
+    size_t size() const {
+        return count;
+    }
+
+    /** Bytes held by the node pool */
+    size_t memoryBytes() const {
+        return pool.capacity() * sizeof(Node);
+    }
+
+    /** Task 4: Perform an in-order traversal */
+    void inorder() const {
+        stack<Index> s;
+        Index current = root;
+        while (current != Null || !s.empty()) {
+            while (current != Null) {
+                s.push(current);
+                current = pool[current].left;
+            }
+            current = s.top();
+            s.pop();
+            cout << pool[current].data << " ";
+            current = pool[current].right;
+        }
+        cout << endl;
+    }
+
+    /** Task 5: Perform a pre-order traversal */
+    void preorder() const {
+        dfsIter();
+    }
+
+    /** Task 6: Perform a post-order traversal */
+    void postorder() const {
+        if (root == Null) {
+            cout << endl;
+            return;
+        }
+        // Reverse of a root-right-left walk is left-right-root
+        stack<Index> s;
+        vector<int> order;
+        s.push(root);
+        while (!s.empty()) {
+            Index current = s.top();
+            s.pop();
+            order.push_back(pool[current].data);
+            if (pool[current].left != Null) s.push(pool[current].left);
+            if (pool[current].right != Null) s.push(pool[current].right);
+        }
+        for (auto it = order.rbegin(); it != order.rend(); ++it) cout << *it << " ";
+        cout << endl;
+    }
+
+    /** Task 7: Perform BFS iteratively */
+    void bfsIter() const {
+        if (root != Null) {
+            queue<Index> q;
+            q.push(root);
+            while (!q.empty()) {
+                const Node& node = pool[q.front()];
+                q.pop();
+                cout << node.data << " ";
+                if (node.left != Null) q.push(node.left);
+                if (node.right != Null) q.push(node.right);
+            }
+        }
+        cout << endl;
+    }
+
+    /** Task 9: Perform DFS iteratively */
+    void dfsIter() const {
+        if (root != Null) {
+            stack<Index> s;
+            s.push(root);
+            while (!s.empty()) {
+                const Node& node = pool[s.top()];
+                s.pop();
+                cout << node.data << " ";
+                if (node.right != Null) s.push(node.right);
+                if (node.left != Null) s.push(node.left);
+            }
+        }
+        cout << endl;
+    }
+
+private:
+    vector<Node> pool;
+    Index root;
+    Index freeList; // chained through Node::left
+    size_t count;
+
+    Index allocate(int data) {
+        count++;
+        if (freeList != Null) {
+            Index slot = freeList;
+            freeList = pool[slot].left;
+            pool[slot] = Node{data, Null, Null};
+            return slot;
+        }
+        if (pool.size() >= (size_t)Null) {
+            count--;
+            throw length_error("IndexedBST: node pool is full, use a wider Index type");
+        }
+        pool.push_back(Node{data, Null, Null});
+        return (Index)(pool.size() - 1);
+    }
+
+    void release(Index slot) {
+        count--;
+        pool[slot].left = freeList;
+        pool[slot].right = Null;
+        freeList = slot;
+    }
+};
+
+#endif /* IndexedBST_h */
@@ -0,0 +1,92 @@
+#include <iostream>
+#include <chrono>
+#include <random>
+#include <vector>
+#include "IntervalTree.h"
+using namespace std;
+
+/**
+ * Interval Tree
+ *
+ * An AVL tree of intervals sorted by their start. Each node also remembers the latest
+ * end anywhere in its subtree (maxHi), which tells a query when a subtree can be skipped.
+ *
+ * Stick figure with maxHi in brackets:
+ *
+ *                [15, 20] (30)
+ *              /              \
+ *       [5, 10] (12)       [17, 19] (30)
+ *        /                        \
+ *   [1, 12] (12)              [25, 30] (30)
+ *
+ * In this figure:
+ * - Asking for 14: the left subtree ends by 12, so it is skipped without looking inside.
+ * - [15, 20] starts after 14, and so does everything to its right, so the search stops.
+ * - Rotations move maxHi along with the nodes, like the height in AVLTree.
+ */
+
+template <typename F>
+long long timeMs(F f) {
+    auto start = chrono::steady_clock::now();
+    f();
+    return chrono::duration_cast<chrono::milliseconds>(chrono::steady_clock::now() - start).count();
+}
+
+void print(const vector<Interval>& intervals) {
+    for (const Interval& i : intervals) cout << "[" << i.lo << ", " << i.hi << "] ";
+    cout << endl;
+}
+
+int main() {
+    IntervalTree tree;
+    tree.insert(15, 20);
+    tree.insert(5, 10);
+    tree.insert(17, 19);
+    tree.insert(1, 12);
+    tree.insert(25, 30);
+
+    cout << "In-order Traversal: ";
+    tree.inorder();
+    cout << "Intervals containing 18: ";
+    print(tree.stab(18));
+    cout << "Intervals overlapping [11, 16]: ";
+    print(tree.overlapping(11, 16));
+
+    tree.remove(15, 20);
+    cout << "Intervals containing 18 after removing [15, 20]: ";
+    print(tree.stab(18));
+
+    // A day of sessions in seconds, each up to ten minutes long
+    const int n = 200000, probes = 20000;
+    mt19937 rng(8);
+    IntervalTree sessions;
+    vector<Interval> all;
+    for (int i = 0; i < n; i++) {
+        int start = (int)(rng() % 86400);
+        int end = start + (int)(rng() % 600);
+        sessions.insert(start, end);
+        all.push_back(Interval{start, end});
+    }
+    vector<int> points(probes);
+    for (int& point : points) point = (int)(rng() % 86400);
+
+    size_t totals[3] = {0, 0, 0};
+    long long scanMs = timeMs([&] {
+        for (int i = 0; i < probes / 100; i++) {
+            for (const Interval& interval : all) totals[0] += interval.contains(points[i]);
+        }
+    });
+    long long stabMs = timeMs([&] {
+        for (int point : points) totals[1] += sessions.stab(point).size();
+    });
+    long long batchMs = timeMs([&] {
+        for (const auto& found : sessions.stabBatch(points)) totals[2] += found.size();
+    });
+
+    cout << "\n" << probes << " stabbing queries over " << sessions.size() << " intervals:\n";
+    cout << "Scan everything: " << scanMs * 100 << " ms (estimated from " << probes / 100 << " queries, "
+         << totals[0] << " hits)\n";
+    cout << "stab():          " << stabMs << " ms (" << totals[1] << " hits)\n";
+    cout << "stabBatch():     " << batchMs << " ms" << (totals[1] == totals[2] ? "" : " (results differ!)") << "\n";
+    return 0;
+}
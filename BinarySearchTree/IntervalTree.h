@@ -0,0 +1,304 @@
+//
+//  IntervalTree.h
+//  BinarySearchTrees
+//
+
+#ifndef IntervalTree_h
+#define IntervalTree_h
+
+#include <iostream>
+#include <algorithm>
+#include <numeric>
+#include <stdexcept>
+#include <utility>
+#include <vector>
+
+using namespace std;
+
+// Closed interval [lo, hi]
+struct Interval {
+    int lo;
+    int hi;
+
+    bool contains(int point) const {
+        return lo <= point && point <= hi;
+    }
+
+    bool overlaps(const Interval& other) const {
+        return lo <= other.hi && other.lo <= hi;
+    }
+
+    bool operator==(const Interval& other) const {
+        return lo == other.lo && hi == other.hi;
+    }
+};
+
+// AVL tree of intervals ordered by (lo, hi).
+// Every node also keeps maxHi, the largest hi in its subtree, which is recomputed by
+// leftRotate/rightRotate and on the way back up from insert and delete. A query can
+// skip a whole subtree when its maxHi ends before the query starts, and can stop going
+// right once lo is past the query's end, so it visits O(log n) nodes per result found
+// and O(log n) when there is nothing to find, instead of all n.
+class IntervalTree {
+public:
+    struct Node {
+        Interval interval;
+        int maxHi;
+        int height;
+        Node* left;
+        Node* right;
+        Node(const Interval& i) : interval(i), maxHi(i.hi), height(1), left(nullptr), right(nullptr) {}
+    };
+
+    Node* root;
+
+    IntervalTree() : root(nullptr), count(0) {}
+
+    ~IntervalTree() {
+        destroyTree(root);
+    }
+
+    //copying would share nodes between two trees, use clone() for a deep copy
+    IntervalTree(const IntervalTree&) = delete;
+    IntervalTree& operator=(const IntervalTree&) = delete;
+
+    IntervalTree(IntervalTree&& other) noexcept : root(other.root), count(other.count) {
+        other.root = nullptr;
+        other.count = 0;
+    }
+
+    IntervalTree& operator=(IntervalTree&& other) noexcept {
+        if (this != &other) {
+            destroyTree(root);
+            root = other.root;
+            count = other.count;
+            other.root = nullptr;
+            other.count = 0;
+        }
+        return *this;
+    }
+
+    //deep copy of the tree
+    IntervalTree clone() const {
+        IntervalTree copy;
+        copy.root = cloneTree(root);
+        copy.count = count;
+        return copy;
+    }
+
+    //insert [lo, hi]; an interval that is already stored is ignored
+    void insert(int lo, int hi) {
+        if (lo > hi) throw invalid_argument("IntervalTree: lo > hi");
+        root = insert(root, Interval{lo, hi});
+    }
+
+    //remove [lo, hi], returns false if it was not stored
+    bool remove(int lo, int hi) {
+        size_t before = count;
+        root = deleteNode(root, Interval{lo, hi});
+        return count != before;
+    }
+
+    size_t size() const {
+        return count;
+    }
+
+    //every interval containing point, sorted by (lo, hi)
+    vector<Interval> stab(int point) const {
+        vector<Interval> found;
+        overlapping(root, Interval{point, point}, found);
+        return found;
+    }
+
+    //every interval sharing at least one point with [lo, hi], sorted by (lo, hi)
+    vector<Interval> overlapping(int lo, int hi) const {
+        vector<Interval> found;
+        if (lo <= hi) overlapping(root, Interval{lo, hi}, found);
+        return found;
+    }
+
+    //stab(points[i]) for every i in one walk of the tree
+    //the points are sorted once, then every node only looks at the points its subtree can
+    //still contain, so a node shared by many answers is visited once instead of per point
+    vector<vector<Interval>> stabBatch(const vector<int>& points) const {
+        vector<size_t> order(points.size());
+        iota(order.begin(), order.end(), 0);
+        sort(order.begin(), order.end(), [&](size_t a, size_t b) { return points[a] < points[b]; });
+        vector<int> sorted(points.size());
+        for (size_t i = 0; i < order.size(); i++) sorted[i] = points[order[i]];
+
+        vector<vector<Interval>> found(points.size());
+        stabBatch(root, sorted, order, 0, sorted.size(), found);
+        return found;
+    }
+
+    //inorder traversal
+    void inorder() const {
+        vector<const Node*> path;
+        const Node* node = root;
+        while (node || !path.empty()) {
+            while (node) {
+                path.push_back(node);
+                node = node->left;
+            }
+            node = path.back();
+            path.pop_back();
+            cout << "[" << node->interval.lo << ", " << node->interval.hi << "] ";
+            node = node->right;
+        }
+        cout << endl;
+    }
+
+private:
+    size_t count;
+
+    static bool less(const Interval& a, const Interval& b) {
+        return a.lo < b.lo || (a.lo == b.lo && a.hi < b.hi);
+    }
+
+    static int height(const Node* node) {
+        return node ? node->height : 0;
+    }
+
+    static int getBalance(const Node* node) {
+        return node ? height(node->left) - height(node->right) : 0;
+    }
+
+    //recompute height and maxHi from the children
+    static void update(Node* node) {
+        node->height = max(height(node->left), height(node->right)) + 1;
+        node->maxHi = node->interval.hi;
+        if (node->left) node->maxHi = max(node->maxHi, node->left->maxHi);
+        if (node->right) node->maxHi = max(node->maxHi, node->right->maxHi);
+    }
+
+    static Node* rightRotate(Node* y) {
+        Node* x = y->left;
+        y->left = x->right;
+        x->right = y;
+        update(y);
+        update(x);
+        return x;
+    }
+
+    static Node* leftRotate(Node* x) {
+        Node* y = x->right;
+        x->right = y->left;
+        y->left = x;
+        update(x);
+        update(y);
+        return y;
+    }
+
+    static Node* rebalance(Node* node) {
+        update(node);
+        int balance = getBalance(node);
+        if (balance > 1) {
+            if (getBalance(node->left) < 0) node->left = leftRotate(node->left);
+            return rightRotate(node);
+        }
+        if (balance < -1) {
+            if (getBalance(node->right) > 0) node->right = rightRotate(node->right);
+            return leftRotate(node);
+        }
+        return node;
+    }
+
+    Node* insert(Node* node, const Interval& interval) {
+        if (!node) {
+            count++;
+            return new Node(interval);
+        }
+        if (less(interval, node->interval)) {
+            node->left = insert(node->left, interval);
+        } else if (less(node->interval, interval)) {
+            node->right = insert(node->right, interval);
+        } else {
+            return node;
+        }
+        return rebalance(node);
+    }
+
+    Node* deleteNode(Node* node, const Interval& interval) {
+        if (!node) return nullptr;
+        if (less(interval, node->interval)) {
+            node->left = deleteNode(node->left, interval);
+        } else if (less(node->interval, interval)) {
+            node->right = deleteNode(node->right, interval);
+        } else {
+            if (!node->left || !node->right) {
+                Node* child = node->left ? node->left : node->right;
+                delete node;
+                count--;
+                return child;
+            }
+            //two children: take the interval of the inorder successor and delete that instead
+            Node* successor = node->right;
+            while (successor->left) successor = successor->left;
+            node->interval = successor->interval;
+            node->right = deleteNode(node->right, successor->interval);
+        }
+        return rebalance(node);
+    }
+
+    static void overlapping(const Node* node, const Interval& query, vector<Interval>& found) {
+        //nothing below ends at or after the start of the query
+        if (!node || node->maxHi < query.lo) return;
+        overlapping(node->left, query, found);
+        //this node and everything to its right start after the query ends
+        if (node->interval.lo > query.hi) return;
+        if (node->interval.hi >= query.lo) found.push_back(node->interval);
+        overlapping(node->right, query, found);
+    }
+
+    //points[begin, end) are sorted; order maps them back to their position in the caller's list
+    static void stabBatch(const Node* node, const vector<int>& points, const vector<size_t>& order,
+                          size_t begin, size_t end, vector<vector<Interval>>& found) {
+        if (!node || begin == end) return;
+        //points after maxHi cannot be in anything below
+        end = upper_bound(points.begin() + begin, points.begin() + end, node->maxHi) - points.begin();
+        if (begin == end) return;
+        stabBatch(node->left, points, order, begin, end, found);
+        //points before lo cannot be in this node or in anything to its right
+        begin = lower_bound(points.begin() + begin, points.begin() + end, node->interval.lo) - points.begin();
+        size_t last = upper_bound(points.begin() + begin, points.begin() + end, node->interval.hi) - points.begin();
+        for (size_t i = begin; i < last; i++) found[order[i]].push_back(node->interval);
+        stabBatch(node->right, points, order, begin, end, found);
+    }
+
+    void destroyTree(Node* node) {
+        while (node) {
+            if (node->left) {
+                Node* left = node->left;
+                node->left = left->right;
+                left->right = node;
+                node = left;
+            } else {
+                Node* right = node->right;
+                delete node;
+                node = right;
+            }
+        }
+    }
+
+    Node* cloneTree(const Node* source) const {
+        if (!source) return nullptr;
+        Node* copy = new Node(*source);
+        vector<Node*> pending(1, copy);
+        while (!pending.empty()) {
+            Node* to = pending.back();
+            pending.pop_back();
+            if (to->left) {
+                to->left = new Node(*to->left);
+                pending.push_back(to->left);
+            }
+            if (to->right) {
+                to->right = new Node(*to->right);
+                pending.push_back(to->right);
+            }
+        }
+        return copy;
+    }
+};
+
+#endif /* IntervalTree_h */
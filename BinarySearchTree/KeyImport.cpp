@@ -0,0 +1,76 @@
+#include <iostream>
+#include <algorithm>
+#include <chrono>
+#include <cstdio>
+#include <fstream>
+#include <random>
+#include <set>
+#include <string>
+#include <vector>
+#include "KeyImport.h"
+using namespace std;
+
+/**
+ * Bulk Key Import
+ *
+ * The file is mapped into memory, cut into chunks, and every chunk is parsed by its own
+ * task. The keys are then sorted once, instead of being inserted one at a time.
+ *
+ * Stick figure of a file cut into three chunks (newlines drawn as spaces):
+ *
+ *     17 42 8 1052 99 23 61 7 3
+ *     [  chunk 1  ][chunk 2 ][3]
+ *              ^
+ *     the first cut landed inside 1052 and moved on to the newline after it
+ *
+ * In this figure:
+ * - A cut always moves forward to a separator, so no key is split between two tasks.
+ * - Every task parses its chunk with from_chars: no stream, no locale, no copies.
+ * - The parsed chunks are joined, sorted and deduplicated in parallel, which is exactly
+ *   what a balanced bulk build needs.
+ */
+
+template <typename F>
+long long timeMs(F f) {
+    auto start = chrono::steady_clock::now();
+    f();
+    return chrono::duration_cast<chrono::milliseconds>(chrono::steady_clock::now() - start).count();
+}
+
+int main() {
+    const string path = "KeyImport.keys.txt";
+    const int n = 5000000;
+    {
+        mt19937 rng(48);
+        ofstream out(path);
+        string line;
+        for (int i = 0; i < n; i++) {
+            line = to_string((int)(rng() % 2000000000) - 1000000000);
+            line += '\n';
+            out << line;
+        }
+    }
+
+    // The usual way: one >> and one insert per key
+    set<int> streamed;
+    long long streamMs = timeMs([&] {
+        ifstream in(path);
+        int key;
+        while (in >> key) streamed.insert(key);
+    });
+
+    vector<int> imported;
+    long long importMs = timeMs([&] { imported = importKeys(path); });
+
+    ifstream sizeCheck(path, ios::binary | ios::ate);
+    double megabytes = sizeCheck.tellg() / double(1 << 20);
+    remove(path.c_str());
+
+    bool same = equal(streamed.begin(), streamed.end(), imported.begin(), imported.end());
+    cout << n << " keys, " << (int)megabytes << " MB of text\n";
+    cout << "ifstream >> and set::insert: " << streamMs << " ms\n";
+    cout << "importKeys:                  " << importMs << " ms, " << (int)(megabytes * 1000 / max(importMs, 1LL))
+         << " MB/s on " << WorkStealingPool::shared().size() << " workers, "
+         << imported.size() << " distinct keys" << (same ? "" : " (MISMATCH)") << endl;
+    return 0;
+}
@@ -0,0 +1,132 @@
+//
+//  KeyImport.h
+//  BinarySearchTrees
+//
+
+#ifndef KeyImport_h
+#define KeyImport_h
+
+#include <algorithm>
+#include <cerrno>
+#include <charconv>
+#include <cstring>
+#include <stdexcept>
+#include <string>
+#include <string_view>
+#include <vector>
+#include <fcntl.h>
+#include <sys/mman.h>
+#include <sys/stat.h>
+#include <unistd.h>
+#include "ParallelSort.h"
+#include "WorkStealingPool.h"
+
+using namespace std;
+
+// Bulk loading of int keys from text: one key per line, or separated by spaces, tabs
+// or commas. The file is mapped into memory instead of read through a stream, cut into
+// chunks at separators, and every chunk is parsed with from_chars by its own task.
+// The parsed keys are then sorted and deduplicated with parallelSortUnique, ready for a
+// balanced bulk build. Nothing is copied line by line and no locale is consulted.
+
+// Bytes parsed by one task, unless the file is too small to give every worker a few
+const size_t ImportChunkBytes = 1 << 22;
+
+inline bool isKeySeparator(char c) {
+    return c == '\n' || c == ' ' || c == '\t' || c == '\r' || c == ',';
+}
+
+/** Parse the keys in text[begin, end) onto out; a bad key throws with its byte offset */
+inline void parseKeyRange(string_view text, size_t begin, size_t end, vector<int>& out) {
+    const char* p = text.data() + begin;
+    const char* stop = text.data() + end;
+    while (true) {
+        while (p < stop && isKeySeparator(*p)) p++;
+        if (p == stop) return;
+        int key;
+        from_chars_result result = from_chars(p, stop, key);
+        if (result.ec != errc() || (result.ptr < stop && !isKeySeparator(*result.ptr))) {
+            throw runtime_error("importKeys: bad key at byte " + to_string(p - text.data()));
+        }
+        out.push_back(key);
+        p = result.ptr;
+    }
+}
+
+/** Parse all keys in text in parallel; returns them sorted without duplicates */
+inline vector<int> parseKeys(string_view text, WorkStealingPool& pool = WorkStealingPool::shared()) {
+    // Chunk boundaries move forward to the next separator so no key is cut in two
+    size_t chunkBytes = max(ImportChunkBytes / 16, min(ImportChunkBytes, text.size() / (4 * pool.size()) + 1));
+    vector<size_t> bounds(1, 0);
+    while (bounds.back() < text.size()) {
+        size_t cut = min(text.size(), bounds.back() + chunkBytes);
+        while (cut < text.size() && !isKeySeparator(text[cut])) cut++;
+        bounds.push_back(cut);
+    }
+    size_t chunks = bounds.size() - 1;
+
+    vector<vector<int>> parsed(chunks);
+    {
+        TaskGroup group(pool);
+        for (size_t c = 0; c < chunks; c++) {
+            group.run([&, c] {
+                // Room for about one key per 8 bytes; the vector grows if keys are shorter
+                parsed[c].reserve((bounds[c + 1] - bounds[c]) / 8);
+                parseKeyRange(text, bounds[c], bounds[c + 1], parsed[c]);
+            });
+        }
+        group.wait();
+    }
+
+    vector<size_t> offsets(chunks + 1, 0);
+    for (size_t c = 0; c < chunks; c++) offsets[c + 1] = offsets[c] + parsed[c].size();
+    vector<int> keys(offsets[chunks]);
+    {
+        TaskGroup group(pool);
+        for (size_t c = 0; c < chunks; c++) {
+            group.run([&, c] {
+                copy(parsed[c].begin(), parsed[c].end(), keys.begin() + offsets[c]);
+                vector<int>().swap(parsed[c]);
+            });
+        }
+        group.wait();
+    }
+    parallelSortUnique(pool, keys);
+    return keys;
+}
+
+/** Read every key in a text file; returns them sorted without duplicates */
+inline vector<int> importKeys(const string& path, WorkStealingPool& pool = WorkStealingPool::shared()) {
+    int fd = open(path.c_str(), O_RDONLY);
+    if (fd < 0) throw runtime_error("importKeys: cannot open " + path + ": " + strerror(errno));
+    struct stat info;
+    if (fstat(fd, &info) != 0) {
+        int error = errno;
+        close(fd);
+        throw runtime_error("importKeys: cannot stat " + path + ": " + strerror(error));
+    }
+    size_t size = (size_t)info.st_size;
+    if (size == 0) {
+        close(fd);
+        return vector<int>();
+    }
+    void* mapped = mmap(nullptr, size, PROT_READ, MAP_PRIVATE, fd, 0);
+    int error = errno;
+    // The mapping keeps the file open by itself
+    close(fd);
+    if (mapped == MAP_FAILED) throw runtime_error("importKeys: cannot map " + path + ": " + strerror(error));
+    // Ask for the whole file up front so the parsers rarely wait on a page fault
+    madvise(mapped, size, MADV_WILLNEED);
+
+    vector<int> keys;
+    try {
+        keys = parseKeys(string_view(static_cast<const char*>(mapped), size), pool);
+    } catch (...) {
+        munmap(mapped, size);
+        throw;
+    }
+    munmap(mapped, size);
+    return keys;
+}
+
+#endif /* KeyImport_h */
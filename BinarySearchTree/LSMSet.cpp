@@ -0,0 +1,77 @@
+#include <iostream>
+#include <chrono>
+#include <random>
+#include <vector>
+#include "LSMSet.h"
+#include "PackedAVL.h"
+using namespace std;
+
+/**
+ * Log-Structured Merge Set
+ *
+ * A balanced tree pays for rebalancing on every insert. An LSM set only keeps a small
+ * tree for the newest keys and turns it into a frozen sorted array when it fills up.
+ * A background thread merges those arrays so there are never too many of them.
+ *
+ * Stick figure (newest on top, x marks a tombstone left by remove):
+ *
+ *   memtable:   { 9  14 }
+ *   tier 0:     [ 3  7x 12 ]   [ 1  7  20 ]
+ *   tier 1:     [ 2  4  5  8  11  15  18 ]
+ *
+ * In this figure:
+ * - contains(7) stops at the first run that has 7, sees the tombstone and says no.
+ * - Once tier 0 holds four runs they are merged into one tier 1 run.
+ * - Iterating merges the memtable and all runs in key order, keeping the newest copy.
+ */
+
+template <typename F>
+long long timeMs(F f) {
+    auto start = chrono::steady_clock::now();
+    f();
+    return chrono::duration_cast<chrono::milliseconds>(chrono::steady_clock::now() - start).count();
+}
+
+int main() {
+    LSMSet set(4);
+    for (int key : {12, 7, 3, 20, 1, 7, 9, 14, 2, 5}) {
+        set.insert(key);
+    }
+    set.remove(7);
+    cout << "In-order Traversal: ";
+    set.inorder();
+    cout << "Contains 7: " << (set.contains(7) ? "yes" : "no") << endl;
+
+    const int n = 4000000;
+    mt19937 rng(13);
+    vector<int> keys(n);
+    for (int& key : keys) key = (int)rng();
+
+    LSMSet lsm;
+    PackedAVLTree avl;
+    long long lsmMs = timeMs([&] {
+        for (int key : keys) lsm.insert(key);
+    });
+    long long flushMs = timeMs([&] { lsm.flush(); });
+    long long avlMs = timeMs([&] {
+        for (int key : keys) avl.insert(key);
+    });
+
+    size_t hits[2] = {0, 0};
+    long long lsmLookupMs = timeMs([&] {
+        for (int i = 0; i < 1000000; i++) hits[0] += lsm.contains(keys[i * 3] + (i & 1));
+    });
+    long long avlLookupMs = timeMs([&] {
+        for (int i = 0; i < 1000000; i++) hits[1] += avl.contains(keys[i * 3] + (i & 1));
+    });
+
+    LSMSet::Stats stats = lsm.stats();
+    cout << "\n" << n << " random inserts:\n";
+    cout << "LSM set:  " << lsmMs << " ms, plus " << flushMs << " ms waiting for the last merges ("
+         << stats.compactions << " merges, " << stats.runs << " runs left)\n";
+    cout << "AVL tree: " << avlMs << " ms\n";
+    cout << "1000000 lookups: LSM set " << lsmLookupMs << " ms (" << hits[0] << " hits, "
+         << stats.filterSkips << " runs skipped by filters), AVL tree " << avlLookupMs << " ms ("
+         << hits[1] << " hits)\n";
+    return 0;
+}
@@ -0,0 +1,309 @@
+//
+//  LSMSet.h
+//  BinarySearchTrees
+//
+
+#ifndef LSMSet_h
+#define LSMSet_h
+
+#include <iostream>
+#include <algorithm>
+#include <climits>
+#include <condition_variable>
+#include <map>
+#include <memory>
+#include <mutex>
+#include <queue>
+#include <thread>
+#include <vector>
+#include "BloomFilter.h"
+
+using namespace std;
+
+// Log-structured merge (LSM) ordered set of ints.
+// Writes go into a small balanced tree (the memtable). When it fills up it is frozen into
+// a sorted run: an immutable array with a Bloom filter and one fence key per 64 entries.
+// A background thread merges runs with tiered compaction: as soon as a tier holds
+// tierFanout runs, they are merged into one run of the next tier. A remove() is written
+// as a tombstone that hides older copies of the key until a merge that reaches the oldest
+// run drops both.
+// Lookups check the memtable, then every run from newest to oldest, skipping runs whose
+// filter rules the key out. Iteration merges all of them in key order, newest copy first.
+// Meant to be used from one thread; the compaction thread only swaps finished runs in.
+class LSMSet {
+public:
+    struct Stats {
+        size_t runs;        // frozen runs right now
+        size_t frozen;      // memtables turned into runs
+        size_t compactions; // merges done by the background thread
+        size_t filterSkips; // runs skipped by lookups thanks to the filter
+    };
+
+    LSMSet(size_t memtableLimit = 4096, size_t tierFanout = 4, double filterFalsePositiveRate = 0.01)
+        : memtableLimit(max<size_t>(memtableLimit, 1)), tierFanout(max<size_t>(tierFanout, 2)),
+          filterRate(filterFalsePositiveRate), stopping(false), merging(false), counters{0, 0, 0, 0} {
+        compactor = thread([this] { compactLoop(); });
+    }
+
+    ~LSMSet() {
+        {
+            lock_guard<mutex> lock(guard);
+            stopping = true;
+        }
+        wake.notify_all();
+        compactor.join();
+    }
+
+    //the set owns a compaction thread, so it can be neither copied nor moved
+    LSMSet(const LSMSet&) = delete;
+    LSMSet& operator=(const LSMSet&) = delete;
+
+    /** Task 2: Insert a key */
+    void insert(int key) {
+        write(key, true);
+    }
+
+    /** Task 3: Remove a key */
+    void remove(int key) {
+        write(key, false);
+    }
+
+    /** Search for a key: memtable first, then runs from newest to oldest */
+    bool contains(int key) {
+        vector<shared_ptr<const Run>> snapshot;
+        {
+            lock_guard<mutex> lock(guard);
+            auto found = memtable.find(key);
+            if (found != memtable.end()) return found->second;
+            snapshot = runs;
+        }
+        size_t skipped = 0;
+        bool result = false;
+        for (const auto& run : snapshot) {
+            if (!run->filter.mayContain(key)) {
+                skipped++;
+                continue;
+            }
+            const Entry* entry = run->find(key);
+            if (entry) {
+                result = entry->live;
+                break;
+            }
+        }
+        lock_guard<mutex> lock(guard);
+        counters.filterSkips += skipped;
+        return result;
+    }
+
+    /** Visit every key in [lo, hi] in increasing order */
+    template <typename F>
+    void forEachInRange(int lo, int hi, F visit) {
+        if (lo > hi) return;
+        // Sources from newest to oldest: the memtable, then the runs
+        vector<Entry> recent;
+        vector<shared_ptr<const Run>> snapshot;
+        {
+            lock_guard<mutex> lock(guard);
+            for (auto it = memtable.lower_bound(lo); it != memtable.end() && it->first <= hi; ++it) {
+                recent.push_back(Entry{it->first, it->second});
+            }
+            snapshot = runs;
+        }
+        vector<pair<const Entry*, const Entry*>> sources;
+        sources.push_back(make_pair(recent.data(), recent.data() + recent.size()));
+        for (const auto& run : snapshot) {
+            const Entry* begin = run->entries.data();
+            const Entry* end = begin + run->entries.size();
+            begin = lower_bound(begin, end, lo, [](const Entry& e, int key) { return e.key < key; });
+            end = upper_bound(begin, end, hi, [](int key, const Entry& e) { return key < e.key; });
+            sources.push_back(make_pair(begin, end));
+        }
+        mergeSources(sources, true, [&](const Entry& entry) { visit(entry.key); });
+    }
+
+    /** Keys in [lo, hi] in sorted order */
+    vector<int> collect(int lo, int hi) {
+        vector<int> keys;
+        forEachInRange(lo, hi, [&](int key) { keys.push_back(key); });
+        return keys;
+    }
+
+    /** Task 4: Perform an in-order traversal */
+    void inorder() {
+        forEachInRange(INT_MIN, INT_MAX, [](int key) { cout << key << " "; });
+        cout << endl;
+    }
+
+    // Number of keys, O(n): tombstones and older copies have to be resolved to know it
+    size_t size() {
+        size_t count = 0;
+        forEachInRange(INT_MIN, INT_MAX, [&](int) { count++; });
+        return count;
+    }
+
+    /** Freeze the memtable and wait until the background thread has no merge left to do */
+    void flush() {
+        unique_lock<mutex> lock(guard);
+        if (!memtable.empty()) freezeLocked();
+        wake.notify_all();
+        idle.wait(lock, [this] { return !merging && !mergeableTier(); });
+    }
+
+    Stats stats() {
+        lock_guard<mutex> lock(guard);
+        Stats s = counters;
+        s.runs = runs.size();
+        return s;
+    }
+
+private:
+    static constexpr size_t FenceStride = 64;
+
+    struct Entry {
+        int key;
+        bool live; // false: tombstone
+    };
+
+    // Immutable sorted run
+    struct Run {
+        vector<Entry> entries;
+        vector<int> fences; // key of every FenceStride-th entry
+        BloomFilter filter;
+        size_t tier;
+
+        Run(vector<Entry>&& sorted, size_t tier, double filterRate)
+            : entries(move(sorted)), filter(entries.size(), filterRate), tier(tier) {
+            fences.reserve(entries.size() / FenceStride + 1);
+            for (size_t i = 0; i < entries.size(); i += FenceStride) fences.push_back(entries[i].key);
+            for (const Entry& entry : entries) filter.add(entry.key);
+        }
+
+        // The fences pick one block of FenceStride entries, which is then binary searched
+        const Entry* find(int key) const {
+            size_t block = upper_bound(fences.begin(), fences.end(), key) - fences.begin();
+            if (block == 0) return nullptr;
+            const Entry* begin = entries.data() + (block - 1) * FenceStride;
+            const Entry* end = entries.data() + min(entries.size(), block * FenceStride);
+            const Entry* found = lower_bound(begin, end, key, [](const Entry& e, int k) { return e.key < k; });
+            return (found != end && found->key == key) ? found : nullptr;
+        }
+    };
+
+    size_t memtableLimit;
+    size_t tierFanout;
+    double filterRate;
+
+    mutex guard;                          // protects everything below
+    condition_variable wake;              // new run or shutdown, for the compactor
+    condition_variable idle;              // compactor finished a merge, for flush()
+    map<int, bool> memtable;              // key -> live, false is a tombstone
+    vector<shared_ptr<const Run>> runs;   // newest first, tiers never decrease
+    bool stopping;
+    bool merging;
+    Stats counters;
+    thread compactor;
+
+    void write(int key, bool live) {
+        bool froze = false;
+        {
+            lock_guard<mutex> lock(guard);
+            memtable[key] = live;
+            if (memtable.size() >= memtableLimit) {
+                freezeLocked();
+                froze = true;
+            }
+        }
+        if (froze) wake.notify_one();
+    }
+
+    void freezeLocked() {
+        vector<Entry> sorted;
+        sorted.reserve(memtable.size());
+        for (const auto& item : memtable) sorted.push_back(Entry{item.first, item.second});
+        memtable.clear();
+        runs.insert(runs.begin(), make_shared<const Run>(move(sorted), 0, filterRate));
+        counters.frozen++;
+    }
+
+    // First index of a group of tierFanout runs in the same tier, or runs.size()
+    size_t mergeableTierStart() const {
+        size_t start = 0;
+        for (size_t i = 1; i <= runs.size(); i++) {
+            if (i == runs.size() || runs[i]->tier != runs[start]->tier) {
+                if (i - start >= tierFanout) return start;
+                start = i;
+            }
+        }
+        return runs.size();
+    }
+
+    bool mergeableTier() const {
+        return mergeableTierStart() < runs.size();
+    }
+
+    void compactLoop() {
+        unique_lock<mutex> lock(guard);
+        while (true) {
+            wake.wait(lock, [this] { return stopping || mergeableTier(); });
+            if (stopping) return;
+
+            size_t start = mergeableTierStart();
+            size_t end = start;
+            while (end < runs.size() && runs[end]->tier == runs[start]->tier) end++;
+            vector<shared_ptr<const Run>> inputs(runs.begin() + start, runs.begin() + end);
+            // Tombstones can go once nothing older is left for them to hide
+            bool oldest = (end == runs.size());
+            size_t tier = runs[start]->tier + 1;
+            merging = true;
+            lock.unlock();
+
+            vector<pair<const Entry*, const Entry*>> sources;
+            size_t total = 0;
+            for (const auto& run : inputs) {
+                sources.push_back(make_pair(run->entries.data(), run->entries.data() + run->entries.size()));
+                total += run->entries.size();
+            }
+            vector<Entry> merged;
+            merged.reserve(total);
+            mergeSources(sources, oldest, [&](const Entry& entry) { merged.push_back(entry); });
+            shared_ptr<const Run> output = make_shared<const Run>(move(merged), tier, filterRate);
+
+            lock.lock();
+            // New runs may have been frozen in front meanwhile; the inputs are still together
+            auto first = find(runs.begin(), runs.end(), inputs.front());
+            first = runs.erase(first, first + inputs.size());
+            runs.insert(first, output);
+            counters.compactions++;
+            merging = false;
+            idle.notify_all();
+        }
+    }
+
+    // k-way merge of sorted sources given newest first; for a key found in several
+    // sources only the newest entry is emitted, and tombstones are skipped if asked
+    template <typename F>
+    static void mergeSources(vector<pair<const Entry*, const Entry*>>& sources, bool dropTombstones, F emit) {
+        typedef pair<int, size_t> Head; // (key, source index)
+        priority_queue<Head, vector<Head>, greater<Head>> heads;
+        for (size_t i = 0; i < sources.size(); i++) {
+            if (sources[i].first != sources[i].second) heads.push(Head(sources[i].first->key, i));
+        }
+        while (!heads.empty()) {
+            Head head = heads.top();
+            heads.pop();
+            const Entry& entry = *sources[head.second].first;
+            if (entry.live || !dropTombstones) emit(entry);
+            // Older sources holding the same key are skipped
+            while (!heads.empty() && heads.top().first == head.first) {
+                size_t older = heads.top().second;
+                heads.pop();
+                if (++sources[older].first != sources[older].second) heads.push(Head(sources[older].first->key, older));
+            }
+            if (++sources[head.second].first != sources[head.second].second) {
+                heads.push(Head(sources[head.second].first->key, head.second));
+            }
+        }
+    }
+};
+
+#endif /* LSMSet_h */
@@ -0,0 +1,119 @@
+#include <iostream>
+#include <algorithm>
+#include <chrono>
+#include <cmath>
+#include <random>
+#include <vector>
+#include "BST.h"
+#include "LearnedIndex.h"
+#include "VebLayout.h"
+using namespace std;
+
+/**
+ * Learned Index
+ *
+ * In a sorted array, the position of a key is a function of the key. A learned index
+ * fits that function with a few straight lines and only searches where the line says
+ * the key should be.
+ *
+ * Stick figure, position against key, with two second-stage models:
+ *
+ *   position
+ *      7 |                    *  *
+ *      6 |                 *          model 2: keys >= 50
+ *      5 |              *
+ *      4 |           *
+ *      3 |   * *  *                   model 1: keys < 50
+ *      2 |  *
+ *      1 | *
+ *      0 |*
+ *        +------------------------- key
+ *
+ * In this figure:
+ * - The first stage looks at the key and picks model 1 or model 2.
+ * - That model's line gives a position, and its error bound (say +-1) gives the few
+ *   slots around it that can hold the key.
+ * - A tree reads about log2(n) keys for every lookup; here it is one window, whose size
+ *   depends on how straight the keys are, not on n.
+ */
+
+/** Pointer tree used as a baseline */
+Node* insertPointer(Node* root, int data) {
+    Node** link = &root;
+    while (*link) {
+        link = (data < (*link)->data) ? &(*link)->left : &(*link)->right;
+    }
+    *link = new Node(data);
+    return root;
+}
+
+bool containsPointer(const Node* node, int data) {
+    while (node) {
+        if (data == node->data) return true;
+        node = (data < node->data) ? node->left : node->right;
+    }
+    return false;
+}
+
+/** Sorted keys of a BST, the same walk as storeInorder */
+void storeInorder(const Node* node, vector<int>& keys) {
+    if (!node) return;
+    storeInorder(node->left, keys);
+    keys.push_back(node->data);
+    storeInorder(node->right, keys);
+}
+
+template <typename F>
+long long timeMs(F f) {
+    auto start = chrono::steady_clock::now();
+    f();
+    return chrono::duration_cast<chrono::milliseconds>(chrono::steady_clock::now() - start).count();
+}
+
+int main() {
+    vector<int> tiny = {1, 2, 3, 4, 5, 6, 10, 20, 30, 40, 50, 52, 54, 56, 58};
+    LearnedIndex small = LearnedIndex::fromSorted(tiny, 2);
+    cout << "Position of 40: " << small.lowerBound(40) << ", of 41: " << small.lowerBound(41) << endl;
+
+    // Log-normal keys: clustered at the low end, sparse at the top, like many real ids
+    const int n = 4000000;
+    mt19937 rng(46);
+    lognormal_distribution<double> spread(0.0, 2.0);
+    Node* root = nullptr;
+    vector<int> probes;
+    for (int i = 0; i < n; i++) {
+        int key = (int)min(2e9, spread(rng) * 1e6);
+        root = insertPointer(root, key);
+        if (i % 2 == 0) probes.push_back(key);
+        else probes.push_back((int)(rng() % 2000000000));
+    }
+    shuffle(probes.begin(), probes.end(), rng);
+
+    vector<int> sorted;
+    storeInorder(root, sorted);
+    LearnedIndex learned;
+    long long buildMs = timeMs([&] { learned = LearnedIndex::fromSorted(sorted); });
+    VebTree veb = VebTree::fromSorted(learned.data());
+
+    size_t hits[3] = {0, 0, 0};
+    long long pointerMs = timeMs([&] {
+        for (int probe : probes) hits[0] += containsPointer(root, probe);
+    });
+    long long vebMs = timeMs([&] {
+        for (int probe : probes) hits[1] += veb.contains(probe);
+    });
+    long long learnedMs = timeMs([&] {
+        for (int probe : probes) hits[2] += learned.contains(probe);
+    });
+
+    LearnedIndex::Stats stats = learned.stats();
+    cout << "\n" << probes.size() << " lookups in " << learned.size() << " keys:\n";
+    cout << "Pointer tree:      " << pointerMs << " ms (" << hits[0] << " hits)\n";
+    cout << "Van Emde Boas:     " << vebMs << " ms (" << hits[1] << " hits)\n";
+    cout << "Learned index:     " << learnedMs << " ms (" << hits[2] << " hits)\n";
+    cout << "Learned index: " << stats.models << " models, " << stats.modelBytes / 1024 << " KB, max error "
+         << stats.maxError << ", mean window " << stats.meanWindow << " keys, built in " << buildMs << " ms\n";
+
+    destroyTree(root);
+    return 0;
+}
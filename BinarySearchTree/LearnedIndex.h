@@ -0,0 +1,174 @@
+//
+//  LearnedIndex.h
+//  BinarySearchTrees
+//
+
+#ifndef LearnedIndex_h
+#define LearnedIndex_h
+
+#include <algorithm>
+#include <vector>
+
+using namespace std;
+
+// Read-only index over sorted keys that predicts where a key sits instead of searching
+// for it: a two-stage recursive model index (RMI, Kraska et al.).
+// The first stage is one straight line from key to model number. Each second-stage model
+// is a straight line fitted to the keys the first stage sends it, from key to position
+// in the array. While building, every second-stage model records the smallest and the
+// largest error it makes on its own keys, so a lookup is two multiply-adds and a binary
+// search over just that error window.
+// Keys missing from the array can land a little outside their model's window; the window
+// is then widened step by doubling step until it brackets the key, so answers are always
+// exact.
+class LearnedIndex {
+public:
+    struct Stats {
+        size_t models;       // second-stage models
+        size_t modelBytes;   // bytes of all models, the key array not counted
+        size_t maxError;     // largest distance between a predicted and a true position
+        double meanWindow;   // keys in the search window, averaged over all keys
+    };
+
+    LearnedIndex() : top{0, 0}, worstError(0), windowTotal(0) {}
+
+    /** Build from keys sorted in increasing order, with models second-stage models (0: n / 128) */
+    static LearnedIndex fromSorted(const vector<int>& sorted, size_t models = 0) {
+        LearnedIndex index;
+        index.build(sorted, models);
+        return index;
+    }
+
+    /** Search for a key */
+    bool contains(int key) const {
+        size_t i = lowerBound(key);
+        return i < keys.size() && keys[i] == key;
+    }
+
+    /** Position of the first key not less than key, or size() if there is none */
+    size_t lowerBound(int key) const {
+        size_t n = keys.size();
+        if (n == 0) return 0;
+        const Leaf& leaf = leaves[leafIndex(key)];
+        long long p = predict(leaf.model, key);
+        size_t lo = (size_t)clampPosition(p + leaf.errLo, n);
+        size_t hi = (size_t)clampPosition(p + leaf.errHi + 1, n);
+        // The window is exact for stored keys; for others grow it until it brackets the key
+        for (size_t step = 1; lo > 0 && keys[lo - 1] >= key; step *= 2) lo = (lo > step) ? lo - step : 0;
+        for (size_t step = 1; hi < n && keys[hi] < key; step *= 2) hi = min(n, hi + step);
+        return lower_bound(keys.begin() + lo, keys.begin() + hi, key) - keys.begin();
+    }
+
+    size_t size() const {
+        return keys.size();
+    }
+
+    /** The sorted keys the index was built over */
+    const vector<int>& data() const {
+        return keys;
+    }
+
+    Stats stats() const {
+        Stats s;
+        s.models = leaves.size();
+        s.modelBytes = sizeof(Linear) + leaves.size() * sizeof(Leaf);
+        s.maxError = worstError;
+        s.meanWindow = keys.empty() ? 0 : (double)windowTotal / keys.size();
+        return s;
+    }
+
+private:
+    struct Linear {
+        double slope;
+        double intercept;
+    };
+
+    struct Leaf {
+        Linear model;
+        int errLo; // true position - predicted position, smallest over this model's keys
+        int errHi; // and largest
+    };
+
+    vector<int> keys;
+    Linear top;
+    vector<Leaf> leaves;
+    size_t worstError;
+    size_t windowTotal;
+
+    static long long clampPosition(long long p, size_t n) {
+        return p < 0 ? 0 : (p > (long long)n ? (long long)n : p);
+    }
+
+    static double at(const Linear& line, int key) {
+        return line.slope * key + line.intercept;
+    }
+
+    long long predict(const Linear& line, int key) const {
+        return clampPosition((long long)at(line, key), keys.size() - 1);
+    }
+
+    size_t leafIndex(int key) const {
+        return (size_t)clampPosition((long long)at(top, key), leaves.size() - 1);
+    }
+
+    //least squares line through (xs[i], i * yScale), centred so big keys keep their precision
+    static Linear fit(const vector<int>& xs, size_t begin, size_t end, double yScale) {
+        size_t count = end - begin;
+        if (count == 0) return Linear{0, 0};
+        double meanX = 0, meanY = 0;
+        for (size_t i = begin; i < end; i++) {
+            meanX += xs[i];
+            meanY += i * yScale;
+        }
+        meanX /= count;
+        meanY /= count;
+        double covariance = 0, variance = 0;
+        for (size_t i = begin; i < end; i++) {
+            double dx = xs[i] - meanX;
+            covariance += dx * (i * yScale - meanY);
+            variance += dx * dx;
+        }
+        // Sorted keys never give a negative slope, so the models keep the key order
+        double slope = variance > 0 ? covariance / variance : 0;
+        return Linear{slope, meanY - slope * meanX};
+    }
+
+    void build(const vector<int>& sorted, size_t models) {
+        keys = sorted;
+        // Counted BSTs repeat keys; positions only make sense for distinct ones
+        keys.erase(unique(keys.begin(), keys.end()), keys.end());
+        size_t n = keys.size();
+        if (models == 0) models = n / 128;
+        models = max<size_t>(1, min(models, max<size_t>(n, 1)));
+
+        // First stage: key -> model number
+        top = fit(keys, 0, n, (double)models / max<size_t>(n, 1));
+        leaves.assign(models, Leaf{Linear{0, 0}, 0, 0});
+
+        // Each model gets a contiguous run of keys because the first stage never decreases
+        size_t begin = 0;
+        while (begin < n) {
+            size_t leaf = leafIndex(keys[begin]);
+            size_t end = begin + 1;
+            while (end < n && leafIndex(keys[end]) == leaf) end++;
+            Leaf& model = leaves[leaf];
+            model.model = fit(keys, begin, end, 1.0);
+            model.errLo = model.errHi = 0;
+            for (size_t i = begin; i < end; i++) {
+                long long error = (long long)i - predict(model.model, keys[i]);
+                if (i == begin || error < model.errLo) model.errLo = (int)error;
+                if (i == begin || error > model.errHi) model.errHi = (int)error;
+            }
+            worstError = max(worstError, (size_t)max(-model.errLo, model.errHi));
+            windowTotal += (end - begin) * (size_t)(model.errHi - model.errLo + 1);
+            begin = end;
+        }
+        // Models that got no keys point at the position their keys would have had
+        for (size_t leaf = 0, next = 0; leaf < models; leaf++) {
+            while (next < n && leafIndex(keys[next]) < leaf) next++;
+            if (leaf != (next < n ? leafIndex(keys[next]) : models)) leaves[leaf].model = Linear{0, (double)next};
+        }
+    }
+};
+
+#endif /* LearnedIndex_h */
@@ -0,0 +1,79 @@
+#include <iostream>
+#include <algorithm>
+#include <chrono>
+#include <iterator>
+#include <random>
+#include <vector>
+#include "MerkleTree.h"
+using namespace std;
+
+/**
+ * Merkle Hashes for Replica Diffing
+ *
+ * Every node keeps a hash of all the keys in its subtree. Two replicas compare the hash
+ * of a key range first and only look inside the ranges where the hashes disagree.
+ *
+ * Stick figure, replica B is missing `7`:
+ *
+ *        Replica A                       Replica B
+ *
+ *        [0, 15] h=...                   [0, 15] h=...   <- differ, cut in half
+ *        /          \                    /          \
+ *   [0, 7]        [8, 15]           [0, 7]        [8, 15]
+ *   {1, 3, 7}     {9, 12}           {1, 3}        {9, 12}
+ *     differ       same               differ       same
+ *
+ * In this figure:
+ * - [8, 15] hashes the same on both sides, so it is never looked at again.
+ * - [0, 7] differs and is small, so both sides list it and `7` shows up as only in A.
+ * - A range hash is a sum of key hashes, so it comes out the same however each
+ *   replica's tree happens to be shaped.
+ */
+
+template <typename F>
+long long timeMs(F f) {
+    auto start = chrono::steady_clock::now();
+    f();
+    return chrono::duration_cast<chrono::milliseconds>(chrono::steady_clock::now() - start).count();
+}
+
+int main() {
+    MerkleTree a, b;
+    for (int key : {1, 3, 7, 9, 12}) a.insert(key);
+    for (int key : {12, 9, 3, 1}) b.insert(key);
+    ReplicaDiff small = diffReplicas(a, b);
+    cout << "Only in A: ";
+    for (int key : small.onlyLeft) cout << key << " ";
+    cout << endl;
+
+    // Two replicas built in different orders, then drifted apart by a few writes
+    const int n = 1000000, changes = 20;
+    mt19937 rng(44);
+    vector<int> keys(n);
+    for (int& key : keys) key = (int)(rng() % 1000000000);
+    MerkleTree left, right;
+    for (int key : keys) left.insert(key);
+    shuffle(keys.begin(), keys.end(), rng);
+    for (int key : keys) right.insert(key);
+    for (int i = 0; i < changes; i++) {
+        left.insert((int)(rng() % 1000000000));
+        right.remove(keys[rng() % n]);
+    }
+
+    ReplicaDiff diff;
+    long long merkleMs = timeMs([&] { diff = diffReplicas(left, right); });
+
+    size_t dumped = 0;
+    long long dumpMs = timeMs([&] {
+        vector<int> x = left.collect(INT_MIN, INT_MAX), y = right.collect(INT_MIN, INT_MAX);
+        vector<int> differ;
+        set_symmetric_difference(x.begin(), x.end(), y.begin(), y.end(), back_inserter(differ));
+        dumped = differ.size();
+    });
+
+    cout << "Replicas of " << n << " keys, " << diff.onlyLeft.size() + diff.onlyRight.size()
+         << " keys differ" << endl;
+    cout << "Merkle diff: " << merkleMs << " ms, " << diff.rangesCompared << " range hashes compared" << endl;
+    cout << "Full dump diff: " << dumpMs << " ms, " << dumped << " keys differ" << endl;
+    return 0;
+}
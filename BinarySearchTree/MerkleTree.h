@@ -0,0 +1,101 @@
+//
+//  MerkleTree.h
+//  BinarySearchTrees
+//
+
+#ifndef MerkleTree_h
+#define MerkleTree_h
+
+#include <climits>
+#include <cstdint>
+#include <utility>
+#include <vector>
+#include "AggregateTree.h"
+
+using namespace std;
+
+// Monoid hashing a set of keys: every key is scrambled with splitmix64 and the results
+// are added up, together with the number of keys. Addition does not care about order or
+// grouping, so the hash of a key range depends only on the keys in it, never on the shape
+// of the tree that stores them. Two replicas that went through different inserts and
+// rotations still agree on the hash of every range they hold the same keys for.
+// This is a checksum against drift, not a defence against someone crafting collisions.
+struct HashMonoid {
+    struct Value {
+        uint64_t hash;
+        size_t count;
+
+        bool operator==(const Value& other) const {
+            return hash == other.hash && count == other.count;
+        }
+        bool operator!=(const Value& other) const {
+            return !(*this == other);
+        }
+    };
+
+    static Value identity() { return Value{0, 0}; }
+
+    static Value lift(int key) {
+        // splitmix64 finalizer
+        uint64_t x = (uint64_t)(uint32_t)key + 0x9e3779b97f4a7c15ULL;
+        x = (x ^ (x >> 30)) * 0xbf58476d1ce4e5b9ULL;
+        x = (x ^ (x >> 27)) * 0x94d049bb133111ebULL;
+        return Value{x ^ (x >> 31), 1};
+    }
+
+    static Value combine(Value a, Value b) { return Value{a.hash + b.hash, a.count + b.count}; }
+};
+
+// Ordered set whose nodes keep the hash of their subtree, updated by insert, remove and
+// rotations like any other AggregateTree, so aggregate(lo, hi) hashes a range in O(log n).
+typedef AggregateTree<HashMonoid> MerkleTree;
+
+// Keys held by only one of two replicas
+struct ReplicaDiff {
+    vector<int> onlyLeft;
+    vector<int> onlyRight;
+    size_t rangesCompared; // range hashes compared on each side
+};
+
+// Compare two replicas top-down over the key space instead of node by node: a range whose
+// hashes match is skipped as a whole, a range that differs is cut in half and both halves
+// are compared. Ranges with at most leafKeys keys on both sides are listed and merged.
+// A handful of differences costs O(d log(key range) log n) instead of a full dump of both
+// trees. Because range hashes do not depend on the tree shape, the same exchange works
+// between hosts that only send each other (lo, hi, hash) triples.
+inline ReplicaDiff diffReplicas(const MerkleTree& left, const MerkleTree& right, size_t leafKeys = 32) {
+    ReplicaDiff diff{vector<int>(), vector<int>(), 0};
+    vector<pair<long long, long long>> pending(1, make_pair((long long)INT_MIN, (long long)INT_MAX));
+    while (!pending.empty()) {
+        long long lo = pending.back().first, hi = pending.back().second;
+        pending.pop_back();
+        HashMonoid::Value a = left.aggregate((int)lo, (int)hi);
+        HashMonoid::Value b = right.aggregate((int)lo, (int)hi);
+        diff.rangesCompared++;
+        if (a == b) continue;
+
+        if (lo == hi || (a.count <= leafKeys && b.count <= leafKeys) || a.count == 0 || b.count == 0) {
+            vector<int> x = left.collect((int)lo, (int)hi);
+            vector<int> y = right.collect((int)lo, (int)hi);
+            size_t i = 0, j = 0;
+            while (i < x.size() || j < y.size()) {
+                if (j == y.size() || (i < x.size() && x[i] < y[j])) {
+                    diff.onlyLeft.push_back(x[i++]);
+                } else if (i == x.size() || y[j] < x[i]) {
+                    diff.onlyRight.push_back(y[j++]);
+                } else {
+                    i++;
+                    j++;
+                }
+            }
+            continue;
+        }
+        // Upper half first so the lower half is popped next and the output comes out sorted
+        long long mid = lo + (hi - lo) / 2;
+        pending.push_back(make_pair(mid + 1, hi));
+        pending.push_back(make_pair(lo, mid));
+    }
+    return diff;
+}
+
+#endif /* MerkleTree_h */
@@ -0,0 +1,129 @@
+//
+//  NodeArena.h
+//  BinarySearchTrees
+//
+
+#ifndef NodeArena_h
+#define NodeArena_h
+
+#include <cstddef>
+#include <new>
+#include <type_traits>
+#include <utility>
+#include <vector>
+
+#if defined(__SANITIZE_ADDRESS__)
+#define NodeArena_asan 1
+#elif defined(__has_feature)
+#if __has_feature(address_sanitizer)
+#define NodeArena_asan 1
+#endif
+#endif
+#ifdef NodeArena_asan
+#include <sanitizer/asan_interface.h>
+#endif
+
+using namespace std;
+
+// Arena for the nodes of one tree, freed together with that tree.
+// Nodes are carved out of large chunks, so nodes built together sit next to each other
+// in memory and none of them costs an allocator call. A freed node goes on the arena's
+// free list and is reused by its next allocate(). allocateBlock() hands out many slots in
+// one piece: a bulk build can fill them from several threads at once, as long as every
+// slot is written by exactly one of them. Everything else is single-threaded, like the
+// tree that owns the arena.
+// Under AddressSanitizer free and unused slots are poisoned, so a node used after it was
+// removed is still reported.
+template <typename T>
+class NodeArena {
+    static_assert(is_trivially_destructible<T>::value, "NodeArena never runs node destructors");
+
+public:
+    NodeArena() : cursor(nullptr), end(nullptr) {}
+
+    ~NodeArena() {
+        for (auto& chunk : chunks) {
+            unpoison(chunk.first, chunk.second);
+            ::operator delete(chunk.first);
+        }
+    }
+
+    // Slots belong to this arena, a copy could not own them
+    NodeArena(const NodeArena&) = delete;
+    NodeArena& operator=(const NodeArena&) = delete;
+
+    /** Room for one node, to be constructed with placement new */
+    void* allocate() {
+        T* slot;
+        if (!freeSlots.empty()) {
+            slot = freeSlots.back();
+            freeSlots.pop_back();
+        } else {
+            if (cursor == end) {
+                cursor = newChunk(NodesPerChunk);
+                end = cursor + NodesPerChunk;
+            }
+            slot = cursor++;
+        }
+        unpoison(slot, 1);
+        return slot;
+    }
+
+    /** Take a node's slot back for reuse */
+    void deallocate(T* node) {
+        if (!node) return;
+        poison(node, 1);
+        freeSlots.push_back(node);
+    }
+
+    /** Room for count nodes in one piece, slot i at block + i; nullptr when count is 0 */
+    T* allocateBlock(size_t count) {
+        if (count == 0) return nullptr;
+        T* block = newChunk(count);
+        unpoison(block, count);
+        return block;
+    }
+
+    /** Bytes taken from the heap */
+    size_t bytes() const {
+        size_t total = 0;
+        for (auto& chunk : chunks) total += chunk.second * sizeof(T);
+        return total;
+    }
+
+private:
+    static constexpr size_t NodesPerChunk = 4096;
+
+    T* cursor; // unused part of the newest chunk
+    T* end;
+    vector<T*> freeSlots;
+    vector<pair<T*, size_t>> chunks; // every chunk with its size in nodes
+
+    T* newChunk(size_t count) {
+        chunks.reserve(chunks.size() + 1);
+        T* chunk = static_cast<T*>(::operator new(count * sizeof(T)));
+        chunks.push_back(make_pair(chunk, count));
+        poison(chunk, count);
+        return chunk;
+    }
+
+    static void poison(T* slots, size_t count) {
+#ifdef NodeArena_asan
+        __asan_poison_memory_region(slots, count * sizeof(T));
+#else
+        (void)slots;
+        (void)count;
+#endif
+    }
+
+    static void unpoison(T* slots, size_t count) {
+#ifdef NodeArena_asan
+        __asan_unpoison_memory_region(slots, count * sizeof(T));
+#else
+        (void)slots;
+        (void)count;
+#endif
+    }
+};
+
+#endif /* NodeArena_h */
@@ -0,0 +1,64 @@
+#include <iostream>
+#include <chrono>
+#include <random>
+#include "PackedAVL.h"
+using namespace std;
+
+/**
+ * Packed AVL Tree
+ *
+ * An AVL tree only needs to know whether each node leans left, leans right or is even.
+ * That is three values, which fit in the two lowest bits of the left child pointer
+ * (nodes sit at addresses that are multiples of 8, so those bits are always zero).
+ *
+ *              20 (+1)
+ *             /       \
+ *        10 (0)        30 (-1)
+ *                     /
+ *                25 (0)
+ *
+ * In this figure:
+ * - The number in brackets is height(right) - height(left) for that node.
+ * - `20` leans right by one, `30` leans left by one, the leaves are even.
+ * - A node is key + pointer + pointer = 24 bytes, instead of 32 with an int height.
+ */
+
+int main() {
+    PackedAVLTree avl;
+    for (int key : {10, 20, 30, 40, 50, 25}) {
+        avl.insert(key);
+    }
+    cout << "Node size: " << sizeof(PackedAVLTree::Node) << " bytes" << endl;
+
+    cout << "In Order Traversal: " << endl;
+    avl.inorder();
+
+    cout << "\nPre-Order Traversal: " << endl;
+    avl.preorder();
+
+    cout << "\nPost-Order Traversal: " << endl;
+    avl.postorder();
+
+    cout << "\nBFS of AVL Balanced Tree:" << endl;
+    avl.bfs();
+
+    cout << "\nDFS of AVL Balanced Tree:" << endl;
+    avl.dfs();
+
+    avl.deleteNode(40);
+    cout << "\nIn Order Traversal after deleting 40: " << endl;
+    avl.inorder();
+    cout << endl;
+
+    //insert/delete churn on a larger tree
+    PackedAVLTree big;
+    mt19937 rng(11);
+    const int n = 1000000;
+    auto start = chrono::steady_clock::now();
+    for (int i = 0; i < n; i++) big.insert((int)(rng() % (n * 4)));
+    for (int i = 0; i < n; i++) big.deleteNode((int)(rng() % (n * 4)));
+    auto end = chrono::steady_clock::now();
+    cout << "\n" << n << " inserts and " << n << " deletes took "
+         << chrono::duration_cast<chrono::milliseconds>(end - start).count() << " ms" << endl;
+    return 0;
+}
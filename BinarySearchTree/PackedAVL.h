@@ -0,0 +1,378 @@
+//
+//  PackedAVL.h
+//  BinarySearchTrees
+//
+
+#ifndef PackedAVL_h
+#define PackedAVL_h
+
+#include <iostream>
+#include <cstdint>
+#include <queue>
+#include <stack>
+#include <utility>
+#include <vector>
+
+using namespace std;
+
+// AVL tree with 24-byte nodes.
+// Instead of an int height, every node keeps its balance factor
+// (height(right) - height(left), always -1, 0 or +1) in the two low bits of its left
+// pointer, which are always zero because nodes are 8-byte aligned. Insert and delete
+// pass a "height changed" flag back up the path and fix balance factors locally, so
+// no heights are ever recomputed.
+class PackedAVLTree {
+public:
+    class Node {
+    public:
+        int key;
+        Node* right;
+
+        explicit Node(int k) : key(k), right(nullptr), leftBits(1) {}
+
+        Node* left() const {
+            return reinterpret_cast<Node*>(leftBits & ~TagMask);
+        }
+
+        void setLeft(Node* node) {
+            leftBits = reinterpret_cast<uintptr_t>(node) | (leftBits & TagMask);
+        }
+
+        int balance() const {
+            return (int)(leftBits & TagMask) - 1;
+        }
+
+        void setBalance(int bf) {
+            leftBits = (leftBits & ~TagMask) | (uintptr_t)(bf + 1);
+        }
+
+    private:
+        static constexpr uintptr_t TagMask = 3;
+        uintptr_t leftBits; // left child pointer | (balance factor + 1)
+    };
+
+    static_assert(alignof(Node) >= 4, "PackedAVLTree needs two free pointer bits");
+
+    Node* root;
+
+    PackedAVLTree() : root(nullptr) {}
+
+    ~PackedAVLTree() {
+        destroyTree(root);
+    }
+
+    //copying would share nodes between two trees, use clone() for a deep copy
+    PackedAVLTree(const PackedAVLTree&) = delete;
+    PackedAVLTree& operator=(const PackedAVLTree&) = delete;
+
+    PackedAVLTree(PackedAVLTree&& other) noexcept : root(other.root) {
+        other.root = nullptr;
+    }
+
+    PackedAVLTree& operator=(PackedAVLTree&& other) noexcept {
+        if (this != &other) {
+            destroyTree(root);
+            root = other.root;
+            other.root = nullptr;
+        }
+        return *this;
+    }
+
+    //deep copy of the tree
+    PackedAVLTree clone() const {
+        PackedAVLTree copy;
+        if (!root) return copy;
+        copy.root = copyNode(root);
+        vector<pair<const Node*, Node*>> pending;
+        pending.push_back(make_pair(root, copy.root));
+        while (!pending.empty()) {
+            const Node* from = pending.back().first;
+            Node* to = pending.back().second;
+            pending.pop_back();
+            if (from->left()) {
+                to->setLeft(copyNode(from->left()));
+                pending.push_back(make_pair(from->left(), to->left()));
+            }
+            if (from->right) {
+                to->right = copyNode(from->right);
+                pending.push_back(make_pair(from->right, to->right));
+            }
+        }
+        return copy;
+    }
+
+    //insert the node
+    void insert(int key) {
+        bool grew = false;
+        root = insert(root, key, grew);
+    }
+
+    //delete the node
+    void deleteNode(int key) {
+        bool shrank = false;
+        root = deleteNode(root, key, shrank);
+    }
+
+    //search for a key
+    bool contains(int key) const {
+        const Node* node = root;
+        while (node) {
+            if (key < node->key) node = node->left();
+            else if (key > node->key) node = node->right;
+            else return true;
+        }
+        return false;
+    }
+
+    //inorder traversal
+    void inorder() const {
+        inorder(root);
+    }
+
+    //pre-order traversal
+    void preorder() const {
+        preorder(root);
+    }
+
+    //post order traversal
+    void postorder() const {
+        postorder(root);
+    }
+
+    //BFS-Breadth First Search
+    void bfs() const {
+        if (!root) return;
+        queue<const Node*> q;
+        q.push(root);
+        while (!q.empty()) {
+            const Node* node = q.front();
+            cout << node->key << " ";
+            q.pop();
+            if (node->left()) q.push(node->left());
+            if (node->right) q.push(node->right);
+        }
+    }
+
+    //DFS-Depth First Search
+    void dfs() const {
+        if (!root) return;
+        stack<const Node*> s;
+        s.push(root);
+        while (!s.empty()) {
+            const Node* node = s.top();
+            cout << node->key << " ";
+            s.pop();
+            if (node->right) s.push(node->right);
+            if (node->left()) s.push(node->left());
+        }
+    }
+
+private:
+    static Node* copyNode(const Node* source) {
+        Node* copy = new Node(source->key);
+        copy->setBalance(source->balance());
+        return copy;
+    }
+
+    //free every node without recursion
+    static void destroyTree(Node* node) {
+        while (node) {
+            if (Node* left = node->left()) {
+                node->setLeft(left->right);
+                left->right = node;
+                node = left;
+            } else {
+                Node* right = node->right;
+                delete node;
+                node = right;
+            }
+        }
+    }
+
+    static Node* rotateRight(Node* y) {
+        Node* x = y->left();
+        y->setLeft(x->right);
+        x->right = y;
+        return x;
+    }
+
+    static Node* rotateLeft(Node* x) {
+        Node* y = x->right;
+        x->right = y->left();
+        y->setLeft(x);
+        return y;
+    }
+
+    // node is two levels taller on the left; returns the new subtree root.
+    // Sets shorter when the subtree ends up one level lower than before the rotation.
+    static Node* fixLeftHeavy(Node* node, bool& shorter) {
+        Node* left = node->left();
+        if (left->balance() == 1) {
+            //left-right case
+            Node* pivot = left->right;
+            int bf = pivot->balance();
+            node->setLeft(rotateLeft(left));
+            Node* top = rotateRight(node);
+            left->setBalance(bf == 1 ? -1 : 0);
+            node->setBalance(bf == -1 ? 1 : 0);
+            top->setBalance(0);
+            shorter = true;
+            return top;
+        }
+        //left-left case; a balanced left child only happens on delete
+        bool wasBalanced = left->balance() == 0;
+        Node* top = rotateRight(node);
+        node->setBalance(wasBalanced ? -1 : 0);
+        top->setBalance(wasBalanced ? 1 : 0);
+        shorter = !wasBalanced;
+        return top;
+    }
+
+    // Mirror image of fixLeftHeavy
+    static Node* fixRightHeavy(Node* node, bool& shorter) {
+        Node* right = node->right;
+        if (right->balance() == -1) {
+            //right-left case
+            Node* pivot = right->left();
+            int bf = pivot->balance();
+            node->right = rotateRight(right);
+            Node* top = rotateLeft(node);
+            right->setBalance(bf == -1 ? 1 : 0);
+            node->setBalance(bf == 1 ? -1 : 0);
+            top->setBalance(0);
+            shorter = true;
+            return top;
+        }
+        //right-right case
+        bool wasBalanced = right->balance() == 0;
+        Node* top = rotateLeft(node);
+        node->setBalance(wasBalanced ? 1 : 0);
+        top->setBalance(wasBalanced ? -1 : 0);
+        shorter = !wasBalanced;
+        return top;
+    }
+
+    // grew reports whether the subtree got taller
+    static Node* insert(Node* node, int key, bool& grew) {
+        if (!node) {
+            grew = true;
+            return new Node(key);
+        }
+        if (key < node->key) {
+            node->setLeft(insert(node->left(), key, grew));
+            if (!grew) return node;
+            int bf = node->balance();
+            if (bf == 1) {
+                node->setBalance(0);
+                grew = false;
+            } else if (bf == 0) {
+                node->setBalance(-1);
+            } else {
+                bool shorter;
+                node = fixLeftHeavy(node, shorter);
+                grew = false;
+            }
+        } else if (key > node->key) {
+            node->right = insert(node->right, key, grew);
+            if (!grew) return node;
+            int bf = node->balance();
+            if (bf == -1) {
+                node->setBalance(0);
+                grew = false;
+            } else if (bf == 0) {
+                node->setBalance(1);
+            } else {
+                bool shorter;
+                node = fixRightHeavy(node, shorter);
+                grew = false;
+            }
+        } else {
+            grew = false;
+        }
+        return node;
+    }
+
+    // The left subtree of node got one level shorter
+    static Node* leftShrank(Node* node, bool& shrank) {
+        int bf = node->balance();
+        if (bf == -1) {
+            node->setBalance(0);
+            return node;
+        }
+        if (bf == 0) {
+            node->setBalance(1);
+            shrank = false;
+            return node;
+        }
+        return fixRightHeavy(node, shrank);
+    }
+
+    // The right subtree of node got one level shorter
+    static Node* rightShrank(Node* node, bool& shrank) {
+        int bf = node->balance();
+        if (bf == 1) {
+            node->setBalance(0);
+            return node;
+        }
+        if (bf == 0) {
+            node->setBalance(-1);
+            shrank = false;
+            return node;
+        }
+        return fixLeftHeavy(node, shrank);
+    }
+
+    // shrank reports whether the subtree got shorter
+    static Node* deleteNode(Node* node, int key, bool& shrank) {
+        if (!node) {
+            shrank = false;
+            return nullptr;
+        }
+        if (key < node->key) {
+            node->setLeft(deleteNode(node->left(), key, shrank));
+            return shrank ? leftShrank(node, shrank) : node;
+        }
+        if (key > node->key) {
+            node->right = deleteNode(node->right, key, shrank);
+            return shrank ? rightShrank(node, shrank) : node;
+        }
+        if (!node->left() || !node->right) {
+            Node* child = node->left() ? node->left() : node->right;
+            delete node;
+            shrank = true;
+            return child;
+        }
+        //two children: take the in-order successor's key
+        Node* successor = node->right;
+        while (successor->left()) successor = successor->left();
+        node->key = successor->key;
+        node->right = deleteNode(node->right, successor->key, shrank);
+        return shrank ? rightShrank(node, shrank) : node;
+    }
+
+    static void inorder(const Node* node) {
+        if (node) {
+            inorder(node->left());
+            cout << node->key << " ";
+            inorder(node->right);
+        }
+    }
+
+    static void preorder(const Node* node) {
+        if (node) {
+            cout << node->key << " ";
+            preorder(node->left());
+            preorder(node->right);
+        }
+    }
+
+    static void postorder(const Node* node) {
+        if (node) {
+            postorder(node->left());
+            postorder(node->right);
+            cout << node->key << " ";
+        }
+    }
+};
+
+#endif /* PackedAVL_h */
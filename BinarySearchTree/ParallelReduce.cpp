@@ -0,0 +1,138 @@
+#include <iostream>
+#include <chrono>
+#include <random>
+#include <stdexcept>
+#include <vector>
+#include "BST.h"
+#include "TreeReduce.h"
+using namespace std;
+
+/**
+ * Parallel Reduce over a Binary Search Tree
+ *
+ * A reduce (or fold) visits every node, maps it to a value and combines the values.
+ * The left and right subtrees of a node do not share any nodes, so they can be
+ * reduced at the same time on different threads and combined afterwards.
+ *
+ * Stick figure of how the work is split:
+ *
+ *                 50             <- combine(left, 50, right)
+ *               /    \
+ *            25        75        <- each subtree is a task
+ *           /  \      /  \
+ *         [..] [..] [..] [..]    <- below the cutoff, tasks walk sequentially
+ *
+ * In this figure:
+ * - The top levels fork a task per subtree on a work-stealing pool.
+ * - Idle threads steal the biggest waiting subtrees from busy threads.
+ * - Below the cutoff a single thread folds the whole subtree with a stack.
+ */
+
+class BST {
+public:
+    Node* root;
+
+    BST() : root(nullptr) {}
+
+    ~BST() {
+        destroyTree(root);
+    }
+
+    // A copy would share nodes with this tree, use clone() for a deep copy
+    BST(const BST&) = delete;
+    BST& operator=(const BST&) = delete;
+
+    BST(BST&& other) noexcept : root(other.root) {
+        other.root = nullptr;
+    }
+
+    BST& operator=(BST&& other) noexcept {
+        if (this != &other) {
+            destroyTree(root);
+            root = other.root;
+            other.root = nullptr;
+        }
+        return *this;
+    }
+
+    /** Deep copy of the tree */
+    BST clone() const {
+        BST copy;
+        copy.root = cloneTree(root);
+        return copy;
+    }
+
+    /** Task 2: Insert a node into the tree */
+    void insert(int data) {
+        Node** link = &root;
+        while (*link) {
+            link = (data < (*link)->data) ? &(*link)->left : &(*link)->right;
+        }
+        *link = new Node(data);
+    }
+
+    /** Task 3: Sum of all keys */
+    long long sum(WorkStealingPool& pool, int forkDepth) {
+        return treeReduce(pool, root, 0LL,
+                          [](Node* n) { return (long long)n->data; },
+                          [](long long a, long long b) { return a + b; }, forkDepth);
+    }
+
+    /** Task 4: Count the keys that satisfy a predicate */
+    template <typename Pred>
+    size_t countIf(Pred pred) {
+        return treeReduce(root, (size_t)0,
+                          [pred](Node* n) { return pred(n->data) ? (size_t)1 : (size_t)0; },
+                          [](size_t a, size_t b) { return a + b; });
+    }
+
+    /** Task 5: Maximum depth of the tree */
+    int maxDepth() {
+        return treeHeight(root);
+    }
+
+    /** Task 6: Histogram of keys in buckets of the given width; keys below 0 count in the first, keys past the end in the last */
+    vector<size_t> histogram(int bucketWidth, int buckets) {
+        if (bucketWidth <= 0 || buckets <= 0) throw invalid_argument("histogram: width and bucket count must be positive");
+        // One histogram per task, not one per node
+        return treeAccumulate(root, vector<size_t>(buckets, 0),
+                              [bucketWidth, buckets](vector<size_t>& h, Node* n) {
+                                  h[n->data < 0 ? 0 : min(n->data / bucketWidth, buckets - 1)]++;
+                              },
+                              [](vector<size_t>& a, const vector<size_t>& b) {
+                                  for (size_t i = 0; i < a.size(); i++) a[i] += b[i];
+                              });
+    }
+};
+
+int main() {
+    BST tree;
+    mt19937 rng(42);
+    const int n = 2000000;
+    for (int i = 0; i < n; i++) {
+        tree.insert((int)(rng() % 1000000));
+    }
+
+    WorkStealingPool& pool = WorkStealingPool::shared();
+    cout << "Tree with " << n << " random keys, pool of " << pool.size() << " threads\n";
+
+    auto start = chrono::steady_clock::now();
+    long long sequential = tree.sum(pool, 0);
+    auto mid = chrono::steady_clock::now();
+    long long parallel = tree.sum(pool, defaultForkDepth(pool));
+    auto end = chrono::steady_clock::now();
+
+    cout << "Sequential sum: " << sequential << " in "
+         << chrono::duration_cast<chrono::milliseconds>(mid - start).count() << " ms\n";
+    cout << "Parallel sum:   " << parallel << " in "
+         << chrono::duration_cast<chrono::milliseconds>(end - mid).count() << " ms\n";
+
+    cout << "Even keys: " << tree.countIf([](int key) { return key % 2 == 0; }) << endl;
+    cout << "Max depth: " << tree.maxDepth() << endl;
+
+    cout << "Histogram (buckets of 250000): ";
+    for (size_t count : tree.histogram(250000, 4)) cout << count << " ";
+    cout << endl;
+
+    return 0;
+}
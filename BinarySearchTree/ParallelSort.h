@@ -0,0 +1,122 @@
+//
+//  ParallelSort.h
+//  BinarySearchTrees
+//
+
+#ifndef ParallelSort_h
+#define ParallelSort_h
+
+#include <algorithm>
+#include <vector>
+#include "WorkStealingPool.h"
+
+using namespace std;
+
+// Below this many elements a sort, merge or scan runs on one thread
+const size_t ParallelSortCutoff = 1 << 16;
+
+/** Merge sorted [a, aEnd) and [b, bEnd) into out, splitting big merges into tasks */
+template <typename T>
+void parallelMerge(WorkStealingPool& pool, const T* a, const T* aEnd, const T* b,
+                   const T* bEnd, T* out) {
+    size_t na = aEnd - a;
+    size_t nb = bEnd - b;
+    if (na + nb <= ParallelSortCutoff) {
+        merge(a, aEnd, b, bEnd, out);
+        return;
+    }
+    // Split the longer run in half and find the matching split point in the other
+    if (na < nb) {
+        swap(a, b);
+        swap(aEnd, bEnd);
+        swap(na, nb);
+    }
+    const T* aMid = a + na / 2;
+    const T* bMid = lower_bound(b, bEnd, *aMid);
+    T* outMid = out + (aMid - a) + (bMid - b);
+
+    TaskGroup group(pool);
+    group.run([&] { parallelMerge(pool, a, aMid, b, bMid, out); });
+    parallelMerge(pool, aMid, aEnd, bMid, bEnd, outMid);
+    group.wait();
+}
+
+/** Sort [first, first + n) using buffer as scratch space; result ends up in first */
+template <typename T>
+void parallelMergeSort(WorkStealingPool& pool, T* first, T* buffer, size_t n) {
+    if (n <= ParallelSortCutoff) {
+        sort(first, first + n);
+        return;
+    }
+    size_t half = n / 2;
+    TaskGroup group(pool);
+    group.run([&] { parallelMergeSort(pool, first, buffer, half); });
+    parallelMergeSort(pool, first + half, buffer + half, n - half);
+    group.wait();
+
+    parallelMerge(pool, first, first + half, first + half, first + n, buffer);
+    // Copy back in parallel chunks
+    size_t chunks = (n + ParallelSortCutoff - 1) / ParallelSortCutoff;
+    TaskGroup copyGroup(pool);
+    for (size_t c = 0; c < chunks; c++) {
+        copyGroup.run([=] {
+            size_t begin = c * ParallelSortCutoff;
+            size_t end = min(n, begin + ParallelSortCutoff);
+            copy(buffer + begin, buffer + end, first + begin);
+        });
+    }
+    copyGroup.wait();
+}
+
+/** Sort the keys and drop duplicates, both in parallel */
+template <typename T>
+void parallelSortUnique(WorkStealingPool& pool, vector<T>& keys) {
+    size_t n = keys.size();
+    if (n <= ParallelSortCutoff) {
+        sort(keys.begin(), keys.end());
+        keys.erase(unique(keys.begin(), keys.end()), keys.end());
+        return;
+    }
+    vector<T> buffer(n);
+    parallelMergeSort(pool, keys.data(), buffer.data(), n);
+
+    // A key survives if it differs from the one before it. Count survivors per
+    // chunk, prefix-sum the counts, then let every chunk write its own slice.
+    size_t chunks = (n + ParallelSortCutoff - 1) / ParallelSortCutoff;
+    vector<size_t> offsets(chunks + 1, 0);
+    {
+        TaskGroup group(pool);
+        for (size_t c = 0; c < chunks; c++) {
+            group.run([&, c] {
+                size_t begin = c * ParallelSortCutoff;
+                size_t end = min(n, begin + ParallelSortCutoff);
+                size_t count = 0;
+                for (size_t i = begin; i < end; i++) {
+                    if (i == 0 || keys[i] != keys[i - 1]) count++;
+                }
+                offsets[c + 1] = count;
+            });
+        }
+        group.wait();
+    }
+    for (size_t c = 0; c < chunks; c++) offsets[c + 1] += offsets[c];
+
+    {
+        TaskGroup group(pool);
+        for (size_t c = 0; c < chunks; c++) {
+            group.run([&, c] {
+                size_t begin = c * ParallelSortCutoff;
+                size_t end = min(n, begin + ParallelSortCutoff);
+                size_t out = offsets[c];
+                for (size_t i = begin; i < end; i++) {
+                    if (i == 0 || keys[i] != keys[i - 1]) buffer[out++] = keys[i];
+                }
+            });
+        }
+        group.wait();
+    }
+    buffer.resize(offsets[chunks]);
+    keys.swap(buffer);
+}
+
+#endif /* ParallelSort_h */
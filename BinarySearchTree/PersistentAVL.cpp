@@ -0,0 +1,68 @@
+#include <iostream>
+#include "PersistentAVL.h"
+#include "../TreePrinter.h"
+using namespace std;
+
+/**
+ * Persistent AVL Tree
+ *
+ * A persistent tree never changes a node once it is built. An insert copies the nodes on
+ * the path from the root to the new key and returns a new root; every subtree that is
+ * off that path is shared with the previous version.
+ *
+ * Stick figure of inserting 7 into version 1:
+ *
+ *     version 1          version 2
+ *         4                  4'
+ *       /   \              /   \
+ *      2     6     -->    2     6'
+ *                                 \
+ *                                  7
+ *
+ * In this figure:
+ * - `4'` and `6'` are new copies, `2` is shared by both versions.
+ * - Version 1 is still a valid tree, so a reader holding it never sees the change.
+ * - Taking a snapshot only adds a reference to the root, and a version's nodes are
+ *   freed when the last reader releases it.
+ */
+
+int main() {
+    TreePrinter printer;
+
+    PersistentAVLTree tree;
+    for (int key : {10, 20, 30, 40, 50, 25}) {
+        tree = tree.insert(key);
+    }
+    cout << "Nodes inserted into Persistent AVL Tree" << endl;
+    printer.printPretty(tree.getRoot(), 1, 0);
+
+    //a reader takes a snapshot while the writer keeps going
+    PersistentAVLTree snapshot = tree.snapshot();
+
+    tree = tree.insert(5).insert(35).deleteNode(20);
+
+    cout << "\nLatest version after inserting 5, 35 and deleting 20:" << endl;
+    printer.printPretty(tree.getRoot(), 1, 0);
+
+    cout << "\nIn Order Traversal (latest): " << endl;
+    tree.inorder();
+
+    cout << "\nIn Order Traversal (snapshot): " << endl;
+    snapshot.inorder();
+
+    cout << "\nPre-Order Traversal (latest): " << endl;
+    tree.preorder();
+
+    cout << "\nPost-Order Traversal (latest): " << endl;
+    tree.postorder();
+
+    cout << "\nBFS of latest version:" << endl;
+    tree.bfs();
+
+    cout << "\nDFS of latest version:" << endl;
+    tree.dfs();
+
+    cout << "\nSnapshot still contains 20: " << (snapshot.contains(20) ? "yes" : "no") << endl;
+    cout << "Latest contains 20: " << (tree.contains(20) ? "yes" : "no") << endl;
+    return 0;
+}
@@ -0,0 +1,279 @@
+//
+//  PersistentAVL.h
+//  BinarySearchTrees
+//
+
+#ifndef PersistentAVL_h
+#define PersistentAVL_h
+
+#include <iostream>
+#include <algorithm>
+#include <atomic>
+#include <queue>
+#include <stack>
+#include <vector>
+
+using namespace std;
+
+// Persistent (path-copying) AVL tree.
+// Nodes are never modified after they are built. insert/deleteNode copy only the
+// nodes on the root-to-key path and return a new version that shares every other
+// subtree with the old one, so a snapshot is just another reference to a root.
+// Each node is reference counted by its parents and by the versions that point at
+// it; when the last reader drops a version, the nodes only it was using are freed.
+class PersistentAVLTree {
+public:
+    struct Node {
+        int key;
+        const Node* left;
+        const Node* right;
+        int height;
+        mutable atomic<int> refs;
+        // Takes over the caller's references to l and r
+        Node(int k, const Node* l, const Node* r)
+            : key(k), left(l), right(r), height(max(heightOf(l), heightOf(r)) + 1), refs(1) {}
+    };
+
+    PersistentAVLTree() : root(nullptr) {}
+
+    // Taking a snapshot is O(1): it only bumps the root's reference count
+    PersistentAVLTree(const PersistentAVLTree& other) : root(retain(other.root)) {}
+
+    PersistentAVLTree(PersistentAVLTree&& other) noexcept : root(other.root) {
+        other.root = nullptr;
+    }
+
+    PersistentAVLTree& operator=(const PersistentAVLTree& other) {
+        if (this != &other) {
+            const Node* old = root;
+            root = retain(other.root);
+            release(old);
+        }
+        return *this;
+    }
+
+    PersistentAVLTree& operator=(PersistentAVLTree&& other) noexcept {
+        if (this != &other) {
+            release(root);
+            root = other.root;
+            other.root = nullptr;
+        }
+        return *this;
+    }
+
+    ~PersistentAVLTree() {
+        release(root);
+    }
+
+    //snapshot of the current version
+    PersistentAVLTree snapshot() const {
+        return *this;
+    }
+
+    //insert the key and return the new version
+    PersistentAVLTree insert(int key) const {
+        return PersistentAVLTree(insert(root, key));
+    }
+
+    //delete the key and return the new version
+    PersistentAVLTree deleteNode(int key) const {
+        if (!contains(key)) return *this;
+        return PersistentAVLTree(deleteNode(root, key));
+    }
+
+    //search for a key
+    bool contains(int key) const {
+        const Node* node = root;
+        while (node) {
+            if (key < node->key) node = node->left;
+            else if (key > node->key) node = node->right;
+            else return true;
+        }
+        return false;
+    }
+
+    const Node* getRoot() const {
+        return root;
+    }
+
+    bool empty() const {
+        return root == nullptr;
+    }
+
+    //inorder traversal
+    void inorder() const {
+        inorder(root);
+    }
+
+    //pre-order traversal
+    void preorder() const {
+        preorder(root);
+    }
+
+    //post order traversal
+    void postorder() const {
+        postorder(root);
+    }
+
+    //BFS-Breadth First Search
+    void bfs() const {
+        if (!root) return;
+        queue<const Node*> q;
+        q.push(root);
+        while (!q.empty()) {
+            const Node* node = q.front();
+            cout << node->key << " ";
+            q.pop();
+            if (node->left) q.push(node->left);
+            if (node->right) q.push(node->right);
+        }
+    }
+
+    //DFS-Depth First Search
+    void dfs() const {
+        if (!root) return;
+        stack<const Node*> s;
+        s.push(root);
+        while (!s.empty()) {
+            const Node* node = s.top();
+            cout << node->key << " ";
+            s.pop();
+            if (node->right) s.push(node->right);
+            if (node->left) s.push(node->left);
+        }
+    }
+
+private:
+    const Node* root;
+
+    // Adopts a root reference that the caller already owns
+    explicit PersistentAVLTree(const Node* r) : root(r) {}
+
+    static int heightOf(const Node* node) {
+        return node ? node->height : 0;
+    }
+
+    static const Node* retain(const Node* node) {
+        if (node) node->refs.fetch_add(1, memory_order_relaxed);
+        return node;
+    }
+
+    // Drops one reference; freeing is iterative so long-lived versions of big trees
+    // can be released without deep recursion
+    static void release(const Node* node) {
+        vector<const Node*> pending;
+        while (true) {
+            if (node && node->refs.fetch_sub(1, memory_order_acq_rel) == 1) {
+                pending.push_back(node->left);
+                pending.push_back(node->right);
+                delete node;
+            }
+            if (pending.empty()) break;
+            node = pending.back();
+            pending.pop_back();
+        }
+    }
+
+    // Builds a balanced node out of l, key and r whose heights differ by at most 2.
+    // Rotations build new nodes instead of relinking, since l and r may be shared.
+    static const Node* balance(int key, const Node* l, const Node* r) {
+        int hl = heightOf(l);
+        int hr = heightOf(r);
+        if (hl > hr + 1) {
+            const Node* result;
+            if (heightOf(l->left) >= heightOf(l->right)) {
+                //single right rotation
+                result = new Node(l->key, retain(l->left),
+                                  new Node(key, retain(l->right), r));
+            } else {
+                //left-right rotation
+                const Node* lr = l->right;
+                result = new Node(lr->key,
+                                  new Node(l->key, retain(l->left), retain(lr->left)),
+                                  new Node(key, retain(lr->right), r));
+            }
+            release(l);
+            return result;
+        }
+        if (hr > hl + 1) {
+            const Node* result;
+            if (heightOf(r->right) >= heightOf(r->left)) {
+                //single left rotation
+                result = new Node(r->key, new Node(key, l, retain(r->left)),
+                                  retain(r->right));
+            } else {
+                //right-left rotation
+                const Node* rl = r->left;
+                result = new Node(rl->key,
+                                  new Node(key, l, retain(rl->left)),
+                                  new Node(r->key, retain(rl->right), retain(r->right)));
+            }
+            release(r);
+            return result;
+        }
+        return new Node(key, l, r);
+    }
+
+    //returns an owned reference to the root of the new version
+    static const Node* insert(const Node* node, int key) {
+        if (!node) return new Node(key, nullptr, nullptr);
+        if (key < node->key) {
+            return balance(node->key, insert(node->left, key), retain(node->right));
+        }
+        if (key > node->key) {
+            return balance(node->key, retain(node->left), insert(node->right, key));
+        }
+        return retain(node);
+    }
+
+    static const Node* minValueNode(const Node* node) {
+        while (node->left) node = node->left;
+        return node;
+    }
+
+    static const Node* deleteMin(const Node* node) {
+        if (!node->left) return retain(node->right);
+        return balance(node->key, deleteMin(node->left), retain(node->right));
+    }
+
+    //returns an owned reference to the root of the new version
+    static const Node* deleteNode(const Node* node, int key) {
+        if (!node) return nullptr;
+        if (key < node->key) {
+            return balance(node->key, deleteNode(node->left, key), retain(node->right));
+        }
+        if (key > node->key) {
+            return balance(node->key, retain(node->left), deleteNode(node->right, key));
+        }
+        if (!node->left) return retain(node->right);
+        if (!node->right) return retain(node->left);
+        const Node* successor = minValueNode(node->right);
+        return balance(successor->key, retain(node->left), deleteMin(node->right));
+    }
+
+    static void inorder(const Node* node) {
+        if (node) {
+            inorder(node->left);
+            cout << node->key << " ";
+            inorder(node->right);
+        }
+    }
+
+    static void preorder(const Node* node) {
+        if (node) {
+            cout << node->key << " ";
+            preorder(node->left);
+            preorder(node->right);
+        }
+    }
+
+    static void postorder(const Node* node) {
+        if (node) {
+            postorder(node->left);
+            postorder(node->right);
+            cout << node->key << " ";
+        }
+    }
+};
+
+#endif /* PersistentAVL_h */
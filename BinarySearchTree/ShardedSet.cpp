@@ -0,0 +1,86 @@
+#include <iostream>
+#include <chrono>
+#include <mutex>
+#include <random>
+#include <thread>
+#include <vector>
+#include "ShardedSet.h"
+using namespace std;
+
+/**
+ * Range-Sharded Set
+ *
+ * The key space is cut into ranges and every range gets its own tree and its own lock,
+ * so writers working on different ranges run side by side.
+ *
+ * Stick figure with three shards:
+ *
+ *     [INT_MIN, 100)        [100, 250)         [250, INT_MAX]
+ *      lock A                lock B             lock C
+ *        40                   180                 300
+ *       /  \                 /   \               /   \
+ *     10    70            120     210          260    900
+ *
+ * In this figure:
+ * - `insert(130)` only takes lock B; an `insert(500)` at the same time takes lock C.
+ * - An in-order walk lists shard A, then B, then C: the ranges never overlap.
+ * - If most writes land in [100, 250), shard B is split at its median and the new
+ *   half gets a lock of its own.
+ */
+
+template <typename F>
+long long timeMs(F f) {
+    auto start = chrono::steady_clock::now();
+    f();
+    return chrono::duration_cast<chrono::milliseconds>(chrono::steady_clock::now() - start).count();
+}
+
+int main() {
+    ShardedSet small(8, 4);
+    for (int key : {40, 10, 70, 180, 120, 210, 300, 260, 900}) small.insert(key);
+    cout << "In-order Traversal: ";
+    small.inorder();
+
+    const int writers = 4, perWriter = 500000, batch = 10000;
+    vector<vector<int>> keys(writers, vector<int>(perWriter));
+    mt19937 rng(45);
+    // Skewed: most keys fall into a narrow band, so resharding has to find it
+    for (auto& part : keys) {
+        for (int& key : part) key = (rng() % 4) ? (int)(rng() % 1000000) : (int)(rng() % 1000000000);
+    }
+
+    AggregateTree<CountMonoid> single;
+    mutex singleLock;
+    long long singleMs = timeMs([&] {
+        vector<thread> threads;
+        for (int w = 0; w < writers; w++) {
+            threads.emplace_back([&, w] {
+                for (int key : keys[w]) {
+                    lock_guard<mutex> guard(singleLock);
+                    single.insert(key);
+                }
+            });
+        }
+        for (auto& t : threads) t.join();
+    });
+
+    ShardedSet sharded;
+    long long shardedMs = timeMs([&] {
+        vector<thread> threads;
+        for (int w = 0; w < writers; w++) {
+            threads.emplace_back([&, w] {
+                for (int i = 0; i < perWriter; i += batch) {
+                    sharded.insertBatch(vector<int>(keys[w].begin() + i, keys[w].begin() + i + batch));
+                }
+            });
+        }
+        for (auto& t : threads) t.join();
+    });
+
+    ShardedSet::Stats stats = sharded.stats();
+    cout << writers << " writers, " << writers * perWriter << " keys" << endl;
+    cout << "One tree, one lock: " << singleMs << " ms, " << single.size() << " keys" << endl;
+    cout << "Sharded, batched: " << shardedMs << " ms, " << sharded.size() << " keys in " << stats.shards
+         << " shards, " << stats.splits << " splits, largest " << stats.largestShard << " keys" << endl;
+    return 0;
+}
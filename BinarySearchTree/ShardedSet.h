@@ -0,0 +1,319 @@
+//
+//  ShardedSet.h
+//  BinarySearchTrees
+//
+
+#ifndef ShardedSet_h
+#define ShardedSet_h
+
+#include <iostream>
+#include <algorithm>
+#include <atomic>
+#include <climits>
+#include <memory>
+#include <mutex>
+#include <shared_mutex>
+#include <vector>
+#include "AggregateTree.h"
+#include "WorkStealingPool.h"
+
+using namespace std;
+
+// Ordered set of ints split by key range into shards, each an AVL tree with its own lock.
+// Threads writing to different ranges never wait for each other, unlike one tree behind
+// one lock. insertBatch() routes a batch to its shards on the pool, then applies every
+// shard's part as one task, so a big ingest runs on all workers and takes each shard
+// lock once.
+// Shards never overlap, so ordered iteration just walks them in key order.
+// Resharding: every reshardInterval writes, each shard that took more than twice its fair
+// share of those writes is split at its median key. Until there are a few shards per
+// worker the busiest one is split anyway, so a set that starts as a single shard spreads
+// out over the range the writes actually hit. Shards are never merged back.
+// The shard list itself is guarded by a reader/writer lock: every operation holds it
+// shared. A split builds both halves from the shard's sorted keys in O(n) while the set
+// stays open, holding only that shard's lock; the list is locked exclusively just to
+// swap the halves in.
+class ShardedSet {
+public:
+    struct Stats {
+        size_t shards;
+        size_t splits;
+        size_t largestShard; // keys in the biggest shard
+    };
+
+    explicit ShardedSet(size_t maxShards = 256, size_t reshardInterval = 1 << 16,
+                        WorkStealingPool& pool = WorkStealingPool::shared())
+        : pool(pool), maxShards(max<size_t>(maxShards, 1)), reshardInterval(max<size_t>(reshardInterval, 1)),
+          recentWrites(0), splits(0) {
+        shards.push_back(unique_ptr<Shard>(new Shard(INT_MIN)));
+    }
+
+    //shards are locked by address, so the set can be neither copied nor moved
+    ShardedSet(const ShardedSet&) = delete;
+    ShardedSet& operator=(const ShardedSet&) = delete;
+
+    /** Task 2: Insert a key */
+    void insert(int key) {
+        {
+            shared_lock<shared_mutex> lock(layout);
+            Shard& shard = shardFor(key);
+            lock_guard<mutex> guard(shard.m);
+            shard.tree.insert(key);
+            shard.writes++;
+        }
+        noteWrites(1);
+    }
+
+    // Insert many keys at once, in parallel on the pool
+    void insertBatch(const vector<int>& keys) {
+        if (keys.empty()) return;
+        {
+            shared_lock<shared_mutex> lock(layout);
+            vector<vector<vector<int>>> routed = route(keys);
+            TaskGroup group(pool);
+            for (size_t s = 0; s < shards.size(); s++) {
+                group.run([this, &routed, s] {
+                    Shard& shard = *shards[s];
+                    lock_guard<mutex> guard(shard.m);
+                    for (const auto& buckets : routed) {
+                        for (int key : buckets[s]) shard.tree.insert(key);
+                        shard.writes += buckets[s].size();
+                    }
+                });
+            }
+            group.wait();
+        }
+        noteWrites(keys.size());
+    }
+
+    // Insert many keys on the calling thread, grouped by shard so each shard lock is
+    // still taken once. For callers that already run one thread per core, like the
+    // TreeServer loops, where forking pool tasks for a small batch costs more than it saves
+    void insertBatchInline(const vector<int>& keys) {
+        if (keys.empty()) return;
+        {
+            shared_lock<shared_mutex> lock(layout);
+            vector<pair<size_t, int>> byShard(keys.size());
+            for (size_t i = 0; i < keys.size(); i++) byShard[i] = make_pair(shardIndex(keys[i]), keys[i]);
+            sort(byShard.begin(), byShard.end());
+            for (size_t i = 0; i < byShard.size();) {
+                Shard& shard = *shards[byShard[i].first];
+                lock_guard<mutex> guard(shard.m);
+                size_t end = i;
+                while (end < byShard.size() && byShard[end].first == byShard[i].first) shard.tree.insert(byShard[end++].second);
+                shard.writes += end - i;
+                i = end;
+            }
+        }
+        noteWrites(keys.size());
+    }
+
+    /** Task 3: Remove a key */
+    void remove(int key) {
+        {
+            shared_lock<shared_mutex> lock(layout);
+            Shard& shard = shardFor(key);
+            lock_guard<mutex> guard(shard.m);
+            shard.tree.remove(key);
+            shard.writes++;
+        }
+        noteWrites(1);
+    }
+
+    bool contains(int key) const {
+        shared_lock<shared_mutex> lock(layout);
+        Shard& shard = shardFor(key);
+        lock_guard<mutex> guard(shard.m);
+        return shard.tree.contains(key);
+    }
+
+    size_t size() const {
+        shared_lock<shared_mutex> lock(layout);
+        size_t total = 0;
+        for (const auto& shard : shards) {
+            lock_guard<mutex> guard(shard->m);
+            total += shard->tree.size();
+        }
+        return total;
+    }
+
+    /** Keys in [lo, hi] in sorted order; each shard is read under its own lock */
+    vector<int> collect(int lo, int hi) const {
+        vector<int> keys;
+        if (lo > hi) return keys;
+        shared_lock<shared_mutex> lock(layout);
+        for (size_t s = shardIndex(lo); s < shards.size() && shards[s]->lo <= hi; s++) {
+            lock_guard<mutex> guard(shards[s]->m);
+            vector<int> part = shards[s]->tree.collect(lo, hi);
+            keys.insert(keys.end(), part.begin(), part.end());
+        }
+        return keys;
+    }
+
+    /** Visit every key in [lo, hi] in increasing order, outside of any lock */
+    template <typename F>
+    void forEachInRange(int lo, int hi, F visit) const {
+        for (int key : collect(lo, hi)) visit(key);
+    }
+
+    /** Task 4: Perform an in-order traversal */
+    void inorder() const {
+        forEachInRange(INT_MIN, INT_MAX, [](int key) { cout << key << " "; });
+        cout << endl;
+    }
+
+    // Lower bound of every shard's key range, in order
+    vector<int> shardBounds() const {
+        shared_lock<shared_mutex> lock(layout);
+        vector<int> bounds;
+        for (const auto& shard : shards) bounds.push_back(shard->lo);
+        return bounds;
+    }
+
+    Stats stats() const {
+        shared_lock<shared_mutex> lock(layout);
+        Stats s{shards.size(), splits, 0};
+        for (const auto& shard : shards) {
+            lock_guard<mutex> guard(shard->m);
+            s.largestShard = max(s.largestShard, shard->tree.size());
+        }
+        return s;
+    }
+
+    // Split the shards that took more than their share of recent writes
+    void reshard() {
+        lock_guard<mutex> running(reshardMutex);
+        reshardLocked();
+    }
+
+private:
+    // Shards smaller than this are not worth splitting
+    static constexpr size_t MinSplitKeys = 64;
+    // Enough shards that stealing can even out uneven ones
+    static constexpr size_t ShardsPerWorker = 4;
+    // Keys routed by one task of insertBatch
+    static constexpr size_t RouteChunk = 1 << 14;
+
+    struct Shard {
+        int lo;                                // smallest key this shard may hold
+        mutable mutex m;                       // protects tree and writes
+        AggregateTree<CountMonoid> tree;
+        size_t writes;                         // updates since the last reshard
+
+        explicit Shard(int lo) : lo(lo), writes(0) {}
+    };
+
+    // Both halves of a shard, built before the shard list is locked to swap them in
+    struct Split {
+        Shard* shard;
+        size_t writesSeen;                     // shard's writes when the halves were built
+        AggregateTree<CountMonoid> lower;
+        unique_ptr<Shard> upper;
+    };
+
+    WorkStealingPool& pool;
+    size_t maxShards;
+    size_t reshardInterval;
+    mutable shared_mutex layout;               // protects the shard list
+    vector<unique_ptr<Shard>> shards;          // sorted by lo, shards[0]->lo == INT_MIN
+    atomic<size_t> recentWrites;
+    size_t splits;
+    mutex reshardMutex;                        // one reshard at a time
+
+    //the last shard whose range starts at or before key
+    size_t shardIndex(int key) const {
+        auto after = upper_bound(shards.begin(), shards.end(), key,
+                                 [](int k, const unique_ptr<Shard>& shard) { return k < shard->lo; });
+        return (after - shards.begin()) - 1;
+    }
+
+    Shard& shardFor(int key) const {
+        return *shards[shardIndex(key)];
+    }
+
+    //bucket keys by shard, one task per chunk: routed[chunk][shard]
+    vector<vector<vector<int>>> route(const vector<int>& keys) const {
+        size_t chunks = (keys.size() + RouteChunk - 1) / RouteChunk;
+        vector<vector<vector<int>>> routed(chunks, vector<vector<int>>(shards.size()));
+        TaskGroup group(pool);
+        for (size_t c = 0; c < chunks; c++) {
+            group.run([this, &keys, &routed, c] {
+                size_t end = min(keys.size(), (c + 1) * RouteChunk);
+                for (size_t i = c * RouteChunk; i < end; i++) routed[c][shardIndex(keys[i])].push_back(keys[i]);
+            });
+        }
+        group.wait();
+        return routed;
+    }
+
+    void noteWrites(size_t count) {
+        size_t before = recentWrites.fetch_add(count, memory_order_relaxed);
+        // Only the write that crosses the interval reshards, and not while another
+        // reshard is still running; that one resets the count when it is done
+        if (before < reshardInterval && before + count >= reshardInterval) {
+            unique_lock<mutex> running(reshardMutex, try_to_lock);
+            if (running.owns_lock()) reshardLocked();
+        }
+    }
+
+    //called with reshardMutex held, so the shard list only changes here
+    void reshardLocked() {
+        vector<Split> planned;
+        {
+            // Pick the hot shards and build their halves; writers to other shards go on
+            shared_lock<shared_mutex> lock(layout);
+            vector<size_t> writes(shards.size());
+            size_t total = 0, busiest = 0;
+            for (size_t s = 0; s < shards.size(); s++) {
+                lock_guard<mutex> guard(shards[s]->m);
+                writes[s] = shards[s]->writes;
+                total += writes[s];
+                if (writes[s] > writes[busiest]) busiest = s;
+            }
+            bool fewShards = shards.size() < ShardsPerWorker * pool.size();
+            size_t fairShare = total / shards.size();
+            for (size_t s = 0; s < shards.size() && shards.size() + planned.size() < maxShards; s++) {
+                bool hot = writes[s] > 2 * fairShare || (fewShards && s == busiest && writes[s] > 0);
+                if (!hot) continue;
+                lock_guard<mutex> guard(shards[s]->m);
+                if (shards[s]->tree.size() >= MinSplitKeys) planned.push_back(splitHalves(*shards[s]));
+            }
+        }
+
+        unique_lock<shared_mutex> lock(layout);
+        vector<unique_ptr<Shard>> next;
+        next.reserve(shards.size() + planned.size());
+        size_t p = 0;
+        for (size_t s = 0; s < shards.size(); s++) {
+            Shard& shard = *shards[s];
+            next.push_back(move(shards[s]));
+            if (p == planned.size() || planned[p].shard != &shard) continue;
+            Split& split = planned[p++];
+            // Written since its halves were built: build them again, nobody else can run now
+            if (shard.writes != split.writesSeen) {
+                if (shard.tree.size() < MinSplitKeys) continue;
+                split = splitHalves(shard);
+            }
+            shard.tree = move(split.lower);
+            next.push_back(move(split.upper));
+            splits++;
+        }
+        for (auto& shard : next) shard->writes = 0;
+        shards.swap(next);
+        recentWrites.store(0, memory_order_relaxed);
+    }
+
+    //lower and upper half of shard's keys, the upper one as a new shard starting at the
+    //median; both are built from the sorted keys in O(n), the shard itself is unchanged
+    //called with the shard's lock or layout held exclusively
+    static Split splitHalves(Shard& shard) {
+        vector<int> keys = shard.tree.collect(INT_MIN, INT_MAX);
+        size_t half = keys.size() / 2;
+        Split split{&shard, shard.writes, AggregateTree<CountMonoid>::fromSorted(keys, 0, half),
+                    unique_ptr<Shard>(new Shard(keys[half]))};
+        split.upper->tree = AggregateTree<CountMonoid>::fromSorted(keys, half, keys.size());
+        return split;
+    }
+};
+
+#endif /* ShardedSet_h */
@@ -0,0 +1,93 @@
+#include <iostream>
+#include <chrono>
+#include <random>
+#include <set>
+#include <string>
+#include <vector>
+// Count how comparisons are decided, for the numbers printed at the end
+#define StringTree_countCompares
+#include "StringBST.h"
+using namespace std;
+
+/**
+ * String Keys
+ *
+ * The prefix every key starts with is stored once for the whole tree. Each node keeps the
+ * next 8 bytes of its key inline; the rest of the key lives in one shared byte array.
+ * A search also remembers how much of the key it has already matched.
+ *
+ * Stick figure, searching for "/usr/lib/zlib" (shared prefix "/", heads in brackets):
+ *
+ *                     "/[usr/lib/]libc"
+ *                     /              \
+ *          "/[etc/host]s"          "/[var/log/]syslog"
+ *                                   /
+ *                           "/[usr/lib/]ssl"
+ *
+ * In this figure:
+ * - At "/usr/lib/libc" the heads are equal, so the tail is read: 'z' > 'l', go right.
+ *   The key shares 8 bytes past the "/" with this smaller ancestor.
+ * - At "/var/log/syslog" the heads differ: one integer compare, go left. The key
+ *   shares 0 bytes past the "/" with this bigger ancestor.
+ * - Everything between two ancestors shares the smaller of those counts with the key,
+ *   and the compare starts after it. Deep in a tree of paths both ancestors share the
+ *   long common directory, and that part is never read again.
+ */
+
+template <typename F>
+long long timeMs(F f) {
+    auto start = chrono::steady_clock::now();
+    f();
+    return chrono::duration_cast<chrono::milliseconds>(chrono::steady_clock::now() - start).count();
+}
+
+int main() {
+    StringTree small;
+    for (const char* key : {"/usr/lib/libc", "/etc/hosts", "/var/log/syslog", "/usr/lib/ssl", "/usr/lib/zlib"}) {
+        small.insert(key);
+    }
+    cout << "In-order Traversal: ";
+    small.inorder();
+    cout << "Under /usr/lib/: ";
+    for (const string& key : small.withPrefix("/usr/lib/")) cout << key << " ";
+    cout << endl;
+
+    // Paths: long shared beginnings, so std::string compares re-read the same bytes
+    const int n = 1000000;
+    mt19937 rng(47);
+    vector<string> keys(n);
+    for (string& key : keys) {
+        key = "/srv/data/customers/" + to_string(rng() % 1000) + "/orders/" + to_string(rng() % 100000) + ".json";
+    }
+
+    set<string> standard;
+    StringTree tree;
+    long long standardInsertMs = timeMs([&] {
+        for (const string& key : keys) standard.insert(key);
+    });
+    long long treeInsertMs = timeMs([&] {
+        for (const string& key : keys) tree.insert(key);
+    });
+
+    size_t hits[2] = {0, 0};
+    long long standardFindMs = timeMs([&] {
+        for (const string& key : keys) hits[0] += standard.count(key);
+    });
+    long long treeFindMs = timeMs([&] {
+        for (const string& key : keys) hits[1] += tree.contains(key);
+    });
+
+    StringTree::Stats stats = tree.stats();
+    // A set node holds the std::string itself; its heap buffer comes on top for long keys
+    size_t standardBytes = 0;
+    for (const string& key : standard) standardBytes += 32 + sizeof(string) + (key.size() > 15 ? key.size() + 1 : 0);
+
+    cout << "\n" << tree.size() << " path keys\n";
+    cout << "std::set<string>: insert " << standardInsertMs << " ms, lookup " << standardFindMs << " ms ("
+         << hits[0] << " hits), about " << standardBytes / (1 << 20) << " MB\n";
+    cout << "StringTree:       insert " << treeInsertMs << " ms, lookup " << treeFindMs << " ms ("
+         << hits[1] << " hits), " << tree.memoryBytes() / (1 << 20) << " MB\n";
+    cout << "Comparisons decided by the heads: " << stats.headCompares << ", reading the arena: " << stats.tailCompares
+         << endl;
+    return 0;
+}
@@ -0,0 +1,475 @@
+//
+//  StringBST.h
+//  BinarySearchTrees
+//
+
+#ifndef StringBST_h
+#define StringBST_h
+
+#include <iostream>
+#include <algorithm>
+#include <atomic>
+#include <cstdint>
+#include <stdexcept>
+#include <string>
+#include <string_view>
+#include <vector>
+
+using namespace std;
+
+// AVL tree of string keys without a std::string per node.
+// The prefix shared by every key in the tree is stored once and left out of the nodes;
+// when a new key breaks it, the prefix is shortened and the keys are rewritten, which
+// only happens a few times as a tree fills up. Every node carries the next 8 bytes of its
+// key inline, packed big-endian into one integer, so comparing two heads is a single
+// integer compare in byte order. Only keys that agree on all 8 head bytes read further,
+// from one shared byte arena that holds every key after its head. A key costs one node
+// plus its bytes past the head, and no string allocation of its own.
+// Searches remember how many leading bytes the key shares with the nearest smaller and
+// the nearest bigger ancestor. Every key below lies between those two, so it shares at
+// least the smaller of the two counts, and comparisons start after that prefix. Long keys
+// with a common beginning, like paths, are then read once per search, not once per level.
+// Keys are stored whole rather than as suffixes of an ancestor's key: rotations change
+// ancestors, and re-encoding keys on every rotation would cost more than it saves.
+// Removed keys leave their bytes behind in the arena; once that is more than half of
+// it, the arena is rewritten with only the live keys.
+// Defining StringTree_countCompares before including this header makes stats() count how
+// comparisons were decided, with relaxed atomics so const lookups may still run side by
+// side. Without it the lookup path counts nothing.
+class StringTree {
+public:
+    struct Node {
+        uint64_t head;   // first 8 bytes after the shared prefix, big-endian, zero padded
+        uint32_t length; // bytes after the shared prefix
+        uint32_t tail;   // arena offset of those bytes past the head
+        int height;
+        Node* left;
+        Node* right;
+        Node(uint64_t h, uint32_t len, uint32_t t)
+            : head(h), length(len), tail(t), height(1), left(nullptr), right(nullptr) {}
+    };
+
+    struct Stats {
+        size_t headCompares;  // comparisons decided by the inline heads, 0 unless counted
+        size_t tailCompares;  // comparisons that had to read the arena, 0 unless counted
+        size_t arenaBytes;
+        size_t deadBytes;     // arena bytes of removed keys
+        size_t sharedPrefix;  // bytes every key starts with, stored once
+    };
+
+    Node* root;
+
+    StringTree() : root(nullptr), count(0), deadBytes(0) {}
+
+    ~StringTree() {
+        destroyTree(root);
+    }
+
+    //copying would share nodes between two trees, use clone() for a deep copy
+    StringTree(const StringTree&) = delete;
+    StringTree& operator=(const StringTree&) = delete;
+
+    StringTree(StringTree&& other) noexcept
+        : root(other.root), count(other.count), common(move(other.common)), arena(move(other.arena)),
+          deadBytes(other.deadBytes) {
+        other.root = nullptr;
+        other.count = 0;
+        other.deadBytes = 0;
+    }
+
+    StringTree& operator=(StringTree&& other) noexcept {
+        if (this != &other) {
+            destroyTree(root);
+            root = other.root;
+            count = other.count;
+            common = move(other.common);
+            arena = move(other.arena);
+            deadBytes = other.deadBytes;
+            other.root = nullptr;
+            other.count = 0;
+            other.deadBytes = 0;
+        }
+        return *this;
+    }
+
+    //deep copy of the tree; the copy's arena only holds live keys
+    StringTree clone() const {
+        StringTree copy;
+        copy.root = cloneTree(root);
+        copy.count = count;
+        copy.common = common;
+        copy.arena = arena;
+        copy.deadBytes = deadBytes;
+        copy.compact();
+        return copy;
+    }
+
+    /** Task 2: Insert a key, returns false if it was already there */
+    bool insert(string_view key) {
+        if (key.size() > UINT32_MAX) throw length_error("StringTree: key too long");
+        if (count == 0) {
+            // A lone key is all shared prefix
+            common.assign(key);
+            arena.clear();
+            deadBytes = 0;
+        } else if (key.compare(0, common.size(), common) != 0) {
+            size_t shared = 0;
+            while (shared < key.size() && key[shared] == common[shared]) shared++;
+            rewrite(shared);
+        }
+        size_t before = count;
+        root = insert(root, Probe(key.substr(common.size())), 0, 0);
+        return count != before;
+    }
+
+    /** Task 3: Remove a key, returns false if it was not there */
+    bool remove(string_view key) {
+        if (key.compare(0, common.size(), common) != 0) return false;
+        size_t before = count;
+        root = deleteNode(root, Probe(key.substr(common.size())), 0, 0);
+        if (count == before) return false;
+        if (deadBytes > arena.size() / 2) compact();
+        return true;
+    }
+
+    /** Search for a key */
+    bool contains(string_view key) const {
+        if (key.compare(0, common.size(), common) != 0) return false;
+        Probe probe(key.substr(common.size()));
+        size_t lcpLow = 0, lcpHigh = 0;
+        const Node* node = root;
+        while (node) {
+            size_t lcp;
+            int order = compare(probe, node, min(lcpLow, lcpHigh), lcp);
+            if (order == 0) return true;
+            if (order < 0) {
+                lcpHigh = lcp;
+                node = node->left;
+            } else {
+                lcpLow = lcp;
+                node = node->right;
+            }
+        }
+        return false;
+    }
+
+    size_t size() const {
+        return count;
+    }
+
+    /** The key stored in a node */
+    string keyOf(const Node* node) const {
+        return common + restOf(node);
+    }
+
+    /** Keys starting with prefix, in sorted order */
+    vector<string> withPrefix(string_view prefix) const {
+        vector<string> keys;
+        // Either every key or none starts with a prefix shorter than the shared one
+        size_t known = min(prefix.size(), common.size());
+        if (prefix.compare(0, known, common, 0, known) != 0) return keys;
+        prefix.remove_prefix(known);
+        vector<const Node*> path;
+        const Node* node = root;
+        Probe probe(prefix);
+        while (node || !path.empty()) {
+            // Subtrees to the left of a key below the prefix cannot hold a match
+            while (node) {
+                size_t lcp;
+                if (compare(probe, node, 0, lcp) > 0) {
+                    node = node->right;
+                } else {
+                    path.push_back(node);
+                    node = node->left;
+                }
+            }
+            if (path.empty()) break;
+            node = path.back();
+            path.pop_back();
+            size_t lcp;
+            compare(probe, node, 0, lcp);
+            if (lcp < prefix.size()) break; // past the last match
+            keys.push_back(keyOf(node));
+            node = node->right;
+        }
+        return keys;
+    }
+
+    /** Task 4: Perform an in-order traversal */
+    void inorder() const {
+        for (const string& key : withPrefix("")) cout << key << " ";
+        cout << endl;
+    }
+
+    // Node slots, arena bytes and vector headroom
+    size_t memoryBytes() const {
+        return count * sizeof(Node) + arena.capacity();
+    }
+
+    Stats stats() const {
+        return Stats{compares.heads(), compares.tails(), arena.size(), deadBytes, common.size()};
+    }
+
+    // Rewrite the arena with only the live keys, in key order
+    void compact() {
+        rewrite(common.size());
+    }
+
+private:
+    static constexpr size_t HeadBytes = 8;
+
+    // How comparisons were decided, counted only when StringTree_countCompares is defined;
+    // a moved-to tree starts counting afresh
+    struct CompareCounts {
+#ifdef StringTree_countCompares
+        atomic<size_t> head{0};
+        atomic<size_t> tail{0};
+        void countHead() { head.fetch_add(1, memory_order_relaxed); }
+        void countTail() { tail.fetch_add(1, memory_order_relaxed); }
+        size_t heads() const { return head.load(memory_order_relaxed); }
+        size_t tails() const { return tail.load(memory_order_relaxed); }
+#else
+        void countHead() {}
+        void countTail() {}
+        size_t heads() const { return 0; }
+        size_t tails() const { return 0; }
+#endif
+    };
+
+    // A key being searched for, with its head packed once up front
+    struct Probe {
+        string_view key;
+        uint64_t head;
+        explicit Probe(string_view k) : key(k), head(pack(k)) {}
+    };
+
+    size_t count;
+    string common;        // prefix of every key, not repeated in the nodes
+    vector<char> arena;   // bytes past the head of every key, removed keys included
+    size_t deadBytes;
+    mutable CompareCounts compares;
+
+    static uint64_t pack(string_view key) {
+        uint64_t head = 0;
+        for (size_t i = 0; i < HeadBytes; i++) {
+            head = (head << 8) | (i < key.size() ? (unsigned char)key[i] : 0);
+        }
+        return head;
+    }
+
+    char byteAt(const Node* node, size_t i) const {
+        return i < HeadBytes ? (char)(node->head >> (8 * (HeadBytes - 1 - i))) : arena[node->tail + i - HeadBytes];
+    }
+
+    //the key of node without the shared prefix
+    string restOf(const Node* node) const {
+        string rest(node->length, '\0');
+        for (size_t i = 0; i < node->length; i++) rest[i] = byteAt(node, i);
+        return rest;
+    }
+
+    //keep the first `keep` bytes of the shared prefix, move the rest into every key and
+    //write a fresh arena holding only the live keys
+    void rewrite(size_t keep) {
+        string moved = common.substr(keep);
+        size_t bytes = arena.size() - deadBytes + count * moved.size();
+        if (bytes > UINT32_MAX) throw length_error("StringTree: arena full");
+        vector<char> fresh;
+        fresh.reserve(bytes);
+        vector<Node*> path;
+        Node* node = root;
+        while (node || !path.empty()) {
+            while (node) {
+                path.push_back(node);
+                node = node->left;
+            }
+            node = path.back();
+            path.pop_back();
+            string rest = moved + restOf(node);
+            node->head = pack(rest);
+            node->length = (uint32_t)rest.size();
+            node->tail = (uint32_t)fresh.size();
+            if (rest.size() > HeadBytes) fresh.insert(fresh.end(), rest.begin() + HeadBytes, rest.end());
+            node = node->right;
+        }
+        common.resize(keep);
+        arena.swap(fresh);
+        deadBytes = 0;
+    }
+
+    //three-way compare of probe against node's key, knowing the first `from` bytes match
+    //lcp receives the length of their common prefix
+    int compare(const Probe& probe, const Node* node, size_t from, size_t& lcp) const {
+        size_t limit = min(probe.key.size(), (size_t)node->length);
+        size_t i = from;
+        bool headsCompared = false;
+        if (i < HeadBytes) {
+            if (probe.head != node->head) {
+                compares.countHead();
+                // The first differing bit tells which byte differs; zero padding past the
+                // end of the shorter key also sorts it first, as it should
+                size_t differ = __builtin_clzll(probe.head ^ node->head) / 8;
+                lcp = min(differ, limit);
+                return probe.head < node->head ? -1 : 1;
+            }
+            headsCompared = true;
+            i = min(HeadBytes, limit);
+        }
+        if (i < limit) {
+            compares.countTail();
+            const char* tail = arena.data() + node->tail;
+            while (i < limit && probe.key[i] == tail[i - HeadBytes]) i++;
+        } else if (headsCompared) {
+            // Equal heads and a key that ends inside them: the lengths decide
+            compares.countHead();
+        }
+        lcp = i;
+        if (i < limit) return (unsigned char)probe.key[i] < (unsigned char)arena[node->tail + i - HeadBytes] ? -1 : 1;
+        return probe.key.size() < node->length ? -1 : (probe.key.size() > node->length ? 1 : 0);
+    }
+
+    Node* makeNode(const Probe& probe) {
+        size_t tailBytes = probe.key.size() > HeadBytes ? probe.key.size() - HeadBytes : 0;
+        if (arena.size() + tailBytes > UINT32_MAX) throw length_error("StringTree: arena full");
+        uint32_t offset = (uint32_t)arena.size();
+        if (tailBytes) arena.insert(arena.end(), probe.key.begin() + HeadBytes, probe.key.end());
+        return new Node(probe.head, (uint32_t)probe.key.size(), offset);
+    }
+
+    static int height(const Node* node) {
+        return node ? node->height : 0;
+    }
+
+    static int getBalance(const Node* node) {
+        return node ? height(node->left) - height(node->right) : 0;
+    }
+
+    static void update(Node* node) {
+        node->height = max(height(node->left), height(node->right)) + 1;
+    }
+
+    static Node* rightRotate(Node* y) {
+        Node* x = y->left;
+        y->left = x->right;
+        x->right = y;
+        update(y);
+        update(x);
+        return x;
+    }
+
+    static Node* leftRotate(Node* x) {
+        Node* y = x->right;
+        x->right = y->left;
+        y->left = x;
+        update(x);
+        update(y);
+        return y;
+    }
+
+    static Node* rebalance(Node* node) {
+        update(node);
+        int balance = getBalance(node);
+        if (balance > 1) {
+            if (getBalance(node->left) < 0) node->left = leftRotate(node->left);
+            return rightRotate(node);
+        }
+        if (balance < -1) {
+            if (getBalance(node->right) > 0) node->right = rightRotate(node->right);
+            return leftRotate(node);
+        }
+        return node;
+    }
+
+    //lcpLow and lcpHigh: common prefix of the key with the nearest smaller and bigger ancestor
+    Node* insert(Node* node, const Probe& probe, size_t lcpLow, size_t lcpHigh) {
+        if (!node) {
+            count++;
+            return makeNode(probe);
+        }
+        size_t lcp;
+        int order = compare(probe, node, min(lcpLow, lcpHigh), lcp);
+        if (order < 0) {
+            node->left = insert(node->left, probe, lcpLow, lcp);
+        } else if (order > 0) {
+            node->right = insert(node->right, probe, lcp, lcpHigh);
+        } else {
+            return node;
+        }
+        return rebalance(node);
+    }
+
+    Node* deleteNode(Node* node, const Probe& probe, size_t lcpLow, size_t lcpHigh) {
+        if (!node) return nullptr;
+        size_t lcp;
+        int order = compare(probe, node, min(lcpLow, lcpHigh), lcp);
+        if (order < 0) {
+            node->left = deleteNode(node->left, probe, lcpLow, lcp);
+        } else if (order > 0) {
+            node->right = deleteNode(node->right, probe, lcp, lcpHigh);
+        } else {
+            deadBytes += node->length > HeadBytes ? node->length - HeadBytes : 0;
+            if (!node->left || !node->right) {
+                Node* child = node->left ? node->left : node->right;
+                delete node;
+                count--;
+                return child;
+            }
+            //two children: take over the key of the inorder successor and unlink that node
+            Node* successor = node->right;
+            while (successor->left) successor = successor->left;
+            node->head = successor->head;
+            node->length = successor->length;
+            node->tail = successor->tail;
+            node->right = removeMin(node->right);
+            count--;
+        }
+        return rebalance(node);
+    }
+
+    //unlink the smallest node below node; its key now lives in another node
+    static Node* removeMin(Node* node) {
+        if (!node->left) {
+            Node* right = node->right;
+            delete node;
+            return right;
+        }
+        node->left = removeMin(node->left);
+        return rebalance(node);
+    }
+
+    void destroyTree(Node* node) {
+        while (node) {
+            if (node->left) {
+                Node* left = node->left;
+                node->left = left->right;
+                left->right = node;
+                node = left;
+            } else {
+                Node* right = node->right;
+                delete node;
+                node = right;
+            }
+        }
+    }
+
+    Node* cloneTree(const Node* source) const {
+        if (!source) return nullptr;
+        Node* copy = new Node(*source);
+        vector<Node*> pending(1, copy);
+        while (!pending.empty()) {
+            Node* to = pending.back();
+            pending.pop_back();
+            if (to->left) {
+                to->left = new Node(*to->left);
+                pending.push_back(to->left);
+            }
+            if (to->right) {
+                to->right = new Node(*to->right);
+                pending.push_back(to->right);
+            }
+        }
+        return copy;
+    }
+};
+
+#endif /* StringBST_h */
@@ -0,0 +1,170 @@
+//
+//  TreeReduce.h
+//  BinarySearchTrees
+//
+
+#ifndef TreeReduce_h
+#define TreeReduce_h
+
+#include <algorithm>
+#include <cmath>
+#include <stack>
+#include <utility>
+#include <vector>
+#include "WorkStealingPool.h"
+
+using namespace std;
+
+// Parallel fold over any binary tree whose nodes have `left` and `right` pointers.
+// map turns one node into a value, combine merges two values and must be associative
+// with identity as its neutral element. Values are combined in in-order sequence, so
+// combine does not have to be commutative.
+//
+// The top forkDepth levels of the tree are split into tasks on the pool; below that
+// cutoff each task walks its subtree sequentially with an explicit stack, so degenerate
+// subtrees do not recurse.
+template <typename NodeT, typename T, typename Map, typename Combine>
+class TreeReducer {
+public:
+    TreeReducer(WorkStealingPool& p, T id, Map m, Combine c, int depth)
+        : pool(p), identity(move(id)), map(move(m)), combine(move(c)), forkDepth(depth) {}
+
+    T reduce(NodeT* node, int depth) {
+        if (!node) return identity;
+        if (depth >= forkDepth) return reduceSequential(node);
+
+        T leftResult = identity;
+        TaskGroup group(pool);
+        group.run([&] { leftResult = reduce(node->left, depth + 1); });
+        T rightResult = reduce(node->right, depth + 1);
+        group.wait();
+        return combine(combine(leftResult, map(node)), rightResult);
+    }
+
+private:
+    WorkStealingPool& pool;
+    T identity;
+    Map map;
+    Combine combine;
+    int forkDepth;
+
+    /** Iterative in-order fold of one subtree */
+    T reduceSequential(NodeT* node) {
+        T result = identity;
+        stack<NodeT*> s;
+        NodeT* current = node;
+        while (current || !s.empty()) {
+            while (current) {
+                s.push(current);
+                current = current->left;
+            }
+            current = s.top();
+            s.pop();
+            result = combine(result, map(current));
+            current = current->right;
+        }
+        return result;
+    }
+};
+
+// Default cutoff: enough levels for about 16 tasks per worker so stealing can even
+// out unbalanced subtrees
+inline int defaultForkDepth(const WorkStealingPool& pool) {
+    return (int)ceil(log2((double)pool.size())) + 4;
+}
+
+template <typename NodeT, typename T, typename Map, typename Combine>
+T treeReduce(WorkStealingPool& pool, NodeT* root, T identity, Map map, Combine combine,
+             int forkDepth) {
+    TreeReducer<NodeT, T, Map, Combine> reducer(pool, move(identity), move(map),
+                                                move(combine), forkDepth);
+    return reducer.reduce(root, 0);
+}
+
+template <typename NodeT, typename T, typename Map, typename Combine>
+T treeReduce(WorkStealingPool& pool, NodeT* root, T identity, Map map, Combine combine) {
+    return treeReduce(pool, root, move(identity), move(map), move(combine),
+                      defaultForkDepth(pool));
+}
+
+template <typename NodeT, typename T, typename Map, typename Combine>
+T treeReduce(NodeT* root, T identity, Map map, Combine combine) {
+    return treeReduce(WorkStealingPool::shared(), root, move(identity), move(map),
+                      move(combine));
+}
+
+// Like treeReduce, but for values that are expensive to create, such as a histogram.
+// Every task keeps one value and adds its nodes to it in place with add(value, node);
+// when two tasks join, merge(value, other) folds the finished value into the other.
+// Nodes are added in in-order sequence, so neither has to be commutative.
+template <typename NodeT, typename T, typename Add, typename Merge>
+T treeAccumulate(WorkStealingPool& pool, NodeT* node, const T& identity, Add& add, Merge& merge,
+                 int forkDepth, int depth = 0) {
+    T result = identity;
+    if (!node) return result;
+    if (depth >= forkDepth) {
+        stack<NodeT*> s;
+        NodeT* current = node;
+        while (current || !s.empty()) {
+            while (current) {
+                s.push(current);
+                current = current->left;
+            }
+            current = s.top();
+            s.pop();
+            add(result, current);
+            current = current->right;
+        }
+        return result;
+    }
+    T rightResult = identity;
+    TaskGroup group(pool);
+    group.run([&] { rightResult = treeAccumulate(pool, node->right, identity, add, merge, forkDepth, depth + 1); });
+    result = treeAccumulate(pool, node->left, identity, add, merge, forkDepth, depth + 1);
+    add(result, node);
+    group.wait();
+    merge(result, rightResult);
+    return result;
+}
+
+template <typename NodeT, typename T, typename Add, typename Merge>
+T treeAccumulate(NodeT* root, const T& identity, Add add, Merge merge) {
+    WorkStealingPool& pool = WorkStealingPool::shared();
+    return treeAccumulate(pool, root, identity, add, merge, defaultForkDepth(pool));
+}
+
+// Height of the tree, computed with the same fork/join split as treeReduce
+template <typename NodeT>
+int treeHeight(WorkStealingPool& pool, NodeT* node, int forkDepth, int depth = 0) {
+    if (!node) return 0;
+    if (depth >= forkDepth) {
+        // Level-by-level walk of the subtree below the cutoff
+        int height = 0;
+        vector<NodeT*> level(1, node);
+        vector<NodeT*> next;
+        while (!level.empty()) {
+            height++;
+            next.clear();
+            for (NodeT* n : level) {
+                if (n->left) next.push_back(n->left);
+                if (n->right) next.push_back(n->right);
+            }
+            level.swap(next);
+        }
+        return height;
+    }
+    int leftHeight = 0;
+    TaskGroup group(pool);
+    group.run([&] { leftHeight = treeHeight(pool, node->left, forkDepth, depth + 1); });
+    int rightHeight = treeHeight(pool, node->right, forkDepth, depth + 1);
+    group.wait();
+    return max(leftHeight, rightHeight) + 1;
+}
+
+template <typename NodeT>
+int treeHeight(NodeT* root) {
+    WorkStealingPool& pool = WorkStealingPool::shared();
+    return treeHeight(pool, root, defaultForkDepth(pool));
+}
+
+#endif /* TreeReduce_h */
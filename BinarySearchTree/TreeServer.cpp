@@ -0,0 +1,98 @@
+#include <iostream>
+#include <chrono>
+#include <random>
+#include <thread>
+#include <vector>
+#include "TreeServer.h"
+using namespace std;
+
+/**
+ * Tree Server
+ *
+ * A set behind a Unix domain socket. Each request is 5 bytes; a client can send many of
+ * them before reading any reply, and the server applies everything one read brings in
+ * as a single batch.
+ *
+ * Stick figure of one pipelined read:
+ *
+ *     client ---- I 5 | I 9 | I 2 | C 9 | R 5 ---->  server
+ *                 \_______________/
+ *                  applied as one batch     then contains, then remove
+ *
+ *     client <---------- 1 1 1 1 1 ----------------  one write
+ *
+ * In this figure:
+ * - The three inserts are applied together, taking each shard lock once.
+ * - `C 9` runs after them, so it sees 9.
+ * - The five replies go back in one write, in request order.
+ */
+
+template <typename F>
+long long timeMs(F f) {
+    auto start = chrono::steady_clock::now();
+    f();
+    return chrono::duration_cast<chrono::milliseconds>(chrono::steady_clock::now() - start).count();
+}
+
+int main() {
+#if defined(__linux__)
+    const string path = "TreeServer.sock";
+    ShardedSet set;
+    TreeServer server(set, path);
+
+    {
+        TreeClient client(path);
+        for (int key : {5, 9, 2}) client.queue(TreeProtocol::OpInsert, key);
+        client.queue(TreeProtocol::OpContains, 9);
+        client.queue(TreeProtocol::OpRemove, 5);
+        vector<char> replies = client.sendQueued();
+        cout << "Pipelined replies: ";
+        for (char reply : replies) cout << (int)reply << " ";
+        cout << "\nContains 5 after removing it: " << client.contains(5) << ", size " << client.size() << endl;
+    }
+
+    const int clients = 4, perClient = 50000, window = 1024;
+    mt19937 rng(49);
+    vector<vector<int>> keys(clients, vector<int>(perClient));
+    for (auto& part : keys) {
+        for (int& key : part) key = (int)(rng() % 100000000);
+    }
+
+    auto runClients = [&](int mode) {
+        vector<thread> threads;
+        for (int c = 0; c < clients; c++) {
+            threads.emplace_back([&, c] {
+                TreeClient client(path);
+                const vector<int>& mine = keys[c];
+                for (int i = 0; i < perClient; i += window) {
+                    int end = min(perClient, i + window);
+                    if (mode == 0) {
+                        for (int k = i; k < end; k++) client.contains(mine[k]);
+                    } else if (mode == 1) {
+                        for (int k = i; k < end; k++) client.queue(TreeProtocol::OpContains, mine[k]);
+                        client.sendQueued();
+                    } else {
+                        client.insertBatch(vector<int>(mine.begin() + i, mine.begin() + end));
+                    }
+                }
+            });
+        }
+        for (auto& t : threads) t.join();
+    };
+
+    long long batchMs = timeMs([&] { runClients(2); });
+    long long singleMs = timeMs([&] { runClients(0); });
+    long long pipelinedMs = timeMs([&] { runClients(1); });
+
+    TreeServer::Stats stats = server.stats();
+    cout << clients << " clients, " << clients * perClient << " keys each way\n";
+    cout << "Batch inserts of " << window << ":        " << batchMs << " ms\n";
+    cout << "Lookups, one round trip each: " << singleMs << " ms\n";
+    cout << "Lookups, pipelined by " << window << ":   " << pipelinedMs << " ms\n";
+    cout << "Server: " << stats.requests << " requests in " << stats.reads << " reads, " << set.size() << " keys\n";
+    if (stats.acceptFailures > 0) cout << "Server: " << stats.acceptFailures << " accepts failed for lack of resources\n";
+#else
+    cout << "TreeServer waits with epoll and needs Linux" << endl;
+#endif
+    return 0;
+}
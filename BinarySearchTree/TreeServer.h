@@ -0,0 +1,528 @@
+//
+//  TreeServer.h
+//  BinarySearchTrees
+//
+
+#ifndef TreeServer_h
+#define TreeServer_h
+
+// The server waits with epoll, so it is only built on Linux
+#if defined(__linux__)
+
+#include <algorithm>
+#include <atomic>
+#include <cerrno>
+#include <chrono>
+#include <cstdint>
+#include <cstring>
+#include <memory>
+#include <stdexcept>
+#include <string>
+#include <thread>
+#include <unordered_map>
+#include <vector>
+#include <fcntl.h>
+#include <sys/epoll.h>
+#include <sys/socket.h>
+#include <sys/stat.h>
+#include <sys/un.h>
+#include <unistd.h>
+#include "ShardedSet.h"
+
+using namespace std;
+
+// Wire format shared by TreeServer and TreeClient. Both ends sit on the same machine,
+// so numbers travel in host byte order.
+// Request: 1 byte op, then a 4-byte int. For OpBatchInsert the int is a count and that
+// many 4-byte keys follow.
+// Reply, in request order: 1 byte (0 or 1) for every op but OpSize, which gets 8 bytes.
+namespace TreeProtocol {
+    const uint8_t OpInsert = 'I';
+    const uint8_t OpRemove = 'R';
+    const uint8_t OpContains = 'C';
+    const uint8_t OpSize = 'S';
+    const uint8_t OpBatchInsert = 'B';
+
+    const size_t HeaderBytes = 5;
+    // Largest OpBatchInsert count the server accepts
+    const uint32_t MaxBatch = 1 << 20;
+
+    inline void put(vector<char>& out, uint8_t op, int32_t value) {
+        out.push_back((char)op);
+        const char* bytes = reinterpret_cast<const char*>(&value);
+        out.insert(out.end(), bytes, bytes + sizeof(value));
+    }
+
+    inline int32_t readInt(const char* p) {
+        int32_t value;
+        memcpy(&value, p, sizeof(value));
+        return value;
+    }
+}
+
+// Serves a ShardedSet over a Unix domain socket.
+// There is one event loop thread per core, each with its own epoll instance. All of
+// them wait on the listening socket with EPOLLEXCLUSIVE, so a new connection wakes one
+// loop, which accepts it and owns it from then on: connection state is never shared and
+// never locked.
+// Clients may pipeline: send many requests without waiting for the replies. Every read
+// takes whatever has arrived, and the complete requests in it are applied in one pass:
+// runs of inserts become one insertBatchInline() call with one lock per shard, and the
+// replies to the whole read go back in one write.
+class TreeServer {
+public:
+    struct Stats {
+        size_t connections;    // accepted so far
+        size_t requests;       // requests applied
+        size_t reads;          // reads that carried at least one complete request
+        size_t acceptFailures; // accepts that failed for lack of descriptors or memory
+    };
+
+    TreeServer(ShardedSet& set, const string& socketPath, unsigned loops = thread::hardware_concurrency())
+        : set(set), path(socketPath), listener(-1), boundDevice(0), boundInode(0),
+          requests(0), reads(0), connections(0), acceptFailures(0) {
+        if (path.size() >= sizeof(sockaddr_un().sun_path)) throw invalid_argument("TreeServer: socket path too long");
+        // A socket left behind by a server that is gone is cleared; a live server's socket,
+        // or anything else at the path, is not ours to delete
+        struct stat existing;
+        if (lstat(path.c_str(), &existing) == 0) {
+            if (!S_ISSOCK(existing.st_mode)) throw runtime_error("TreeServer: " + path + " exists and is not a socket");
+            if (!isStale(path)) throw runtime_error("TreeServer: " + path + " is in use");
+            unlink(path.c_str());
+        }
+        listener = socket(AF_UNIX, SOCK_STREAM | SOCK_NONBLOCK | SOCK_CLOEXEC, 0);
+        if (listener < 0) throw runtime_error(string("TreeServer: socket failed: ") + strerror(errno));
+        sockaddr_un address = unixAddress(path);
+        if (bind(listener, (sockaddr*)&address, sizeof(address)) != 0 || listen(listener, SOMAXCONN) != 0) {
+            int error = errno;
+            close(listener);
+            throw runtime_error("TreeServer: cannot listen on " + path + ": " + strerror(error));
+        }
+        struct stat bound;
+        if (lstat(path.c_str(), &bound) == 0) {
+            boundDevice = bound.st_dev;
+            boundInode = bound.st_ino;
+        }
+        try {
+            for (unsigned i = 0; i < max(loops, 1u); i++) this->loops.push_back(unique_ptr<Loop>(new Loop(listener)));
+            for (auto& loop : this->loops) {
+                Loop* l = loop.get();
+                l->worker = thread([this, l] { run(*l); });
+            }
+        } catch (...) {
+            // Loops already running must be stopped before their state goes away
+            stopLoops();
+            this->loops.clear();
+            close(listener);
+            unlinkOwnSocket();
+            throw;
+        }
+    }
+
+    ~TreeServer() {
+        stopLoops();
+        loops.clear();
+        close(listener);
+        unlinkOwnSocket();
+    }
+
+    //the loops hold a pointer to the server
+    TreeServer(const TreeServer&) = delete;
+    TreeServer& operator=(const TreeServer&) = delete;
+
+    Stats stats() const {
+        return Stats{connections.load(), requests.load(), reads.load(), acceptFailures.load()};
+    }
+
+    static sockaddr_un unixAddress(const string& path) {
+        sockaddr_un address;
+        memset(&address, 0, sizeof(address));
+        address.sun_family = AF_UNIX;
+        strncpy(address.sun_path, path.c_str(), sizeof(address.sun_path) - 1);
+        return address;
+    }
+
+private:
+    // Bytes read from a socket at a time
+    static constexpr size_t ReadBytes = 1 << 16;
+    // Stop reading from a client that has this many reply bytes it is not picking up
+    static constexpr size_t MaxPendingReply = 1 << 22;
+    // How long a loop leaves the listener alone after accept fails for lack of resources
+    static constexpr int AcceptBackoffMs = 100;
+
+    struct Connection {
+        int fd;
+        vector<char> in;    // received bytes not yet applied, at most one partial request
+        vector<char> out;   // replies not yet written
+        uint32_t watching;  // epoll events registered right now
+    };
+
+    struct Loop {
+        int epoll;
+        int wakeRead;
+        int wakeWrite;
+        unordered_map<int, Connection> connections;
+        thread worker;
+        bool accepting;                           // listener registered with this epoll
+        chrono::steady_clock::time_point resume;  // when to register it again otherwise
+
+        explicit Loop(int listener) : epoll(-1), wakeRead(-1), wakeWrite(-1), accepting(true) {
+            int wake[2];
+            if (pipe2(wake, O_NONBLOCK | O_CLOEXEC) != 0) throw runtime_error(string("TreeServer: pipe failed: ") + strerror(errno));
+            wakeRead = wake[0];
+            wakeWrite = wake[1];
+            epoll = epoll_create1(EPOLL_CLOEXEC);
+            epoll_event listen{};
+            listen.events = EPOLLIN | EPOLLEXCLUSIVE;
+            listen.data.fd = listener;
+            epoll_event stop{};
+            stop.events = EPOLLIN;
+            stop.data.fd = wakeRead;
+            if (epoll < 0 || epoll_ctl(epoll, EPOLL_CTL_ADD, listener, &listen) != 0 ||
+                epoll_ctl(epoll, EPOLL_CTL_ADD, wakeRead, &stop) != 0) {
+                int error = errno;
+                closeAll();
+                throw runtime_error(string("TreeServer: epoll setup failed: ") + strerror(error));
+            }
+        }
+
+        ~Loop() {
+            for (auto& item : connections) close(item.first);
+            closeAll();
+        }
+
+        void closeAll() {
+            if (epoll >= 0) close(epoll);
+            close(wakeRead);
+            close(wakeWrite);
+        }
+    };
+
+    ShardedSet& set;
+    string path;
+    int listener;
+    dev_t boundDevice; // identity of the socket file bind() created, 0/0 if unknown
+    ino_t boundInode;
+    vector<unique_ptr<Loop>> loops;
+    atomic<size_t> requests;
+    atomic<size_t> reads;
+    atomic<size_t> connections;
+    atomic<size_t> acceptFailures;
+
+    //whether the socket at path has no server behind it: connecting is refused
+    static bool isStale(const string& path) {
+        int probe = socket(AF_UNIX, SOCK_STREAM | SOCK_NONBLOCK | SOCK_CLOEXEC, 0);
+        if (probe < 0) throw runtime_error(string("TreeServer: socket failed: ") + strerror(errno));
+        sockaddr_un address = unixAddress(path);
+        bool refused = connect(probe, (sockaddr*)&address, sizeof(address)) != 0 &&
+                       (errno == ECONNREFUSED || errno == ENOENT);
+        close(probe);
+        return refused;
+    }
+
+    //remove the socket file, unless someone else has replaced it since bind()
+    void unlinkOwnSocket() {
+        struct stat current;
+        if (lstat(path.c_str(), &current) != 0) return;
+        if (current.st_dev == boundDevice && current.st_ino == boundInode) unlink(path.c_str());
+    }
+
+    //wake every running loop and wait for it to return
+    void stopLoops() {
+        for (auto& loop : loops) {
+            if (!loop->worker.joinable()) continue;
+            char byte = 0;
+            (void)!write(loop->wakeWrite, &byte, 1);
+        }
+        for (auto& loop : loops) {
+            if (loop->worker.joinable()) loop->worker.join();
+        }
+    }
+
+    void run(Loop& loop) {
+        epoll_event events[64];
+        while (true) {
+            int timeout = -1;
+            if (!loop.accepting) {
+                auto left = chrono::duration_cast<chrono::milliseconds>(loop.resume - chrono::steady_clock::now()).count();
+                if (left <= 0) {
+                    resumeAccepting(loop);
+                } else {
+                    timeout = (int)left + 1;
+                }
+            }
+            int ready = epoll_wait(loop.epoll, events, 64, timeout);
+            if (ready < 0) {
+                if (errno == EINTR) continue;
+                return;
+            }
+            for (int i = 0; i < ready; i++) {
+                int fd = events[i].data.fd;
+                if (fd == loop.wakeRead) return;
+                if (fd == listener) {
+                    acceptAll(loop);
+                    continue;
+                }
+                auto found = loop.connections.find(fd);
+                if (found == loop.connections.end()) continue;
+                Connection& connection = found->second;
+                bool open = true;
+                if (events[i].events & (EPOLLIN | EPOLLHUP | EPOLLERR)) open = readAndApply(connection);
+                if (open) open = flush(loop, connection);
+                if (!open) {
+                    close(fd);
+                    loop.connections.erase(found);
+                }
+            }
+        }
+    }
+
+    void acceptAll(Loop& loop) {
+        while (true) {
+            int fd = accept4(listener, nullptr, nullptr, SOCK_NONBLOCK | SOCK_CLOEXEC);
+            if (fd < 0) {
+                if (errno == EINTR || errno == ECONNABORTED) continue;
+                // Another loop took it, or nothing is left
+                if (errno == EAGAIN || errno == EWOULDBLOCK) return;
+                pauseAccepting(loop);
+                return;
+            }
+            epoll_event event{};
+            event.events = EPOLLIN;
+            event.data.fd = fd;
+            if (epoll_ctl(loop.epoll, EPOLL_CTL_ADD, fd, &event) != 0) {
+                close(fd);
+                continue;
+            }
+            loop.connections[fd] = Connection{fd, vector<char>(), vector<char>(), EPOLLIN};
+            connections++;
+        }
+    }
+
+    //accept failed for lack of descriptors or memory; the pending connection keeps the
+    //level-triggered listener readable, so stop watching it for a while instead of spinning
+    void pauseAccepting(Loop& loop) {
+        acceptFailures++;
+        epoll_ctl(loop.epoll, EPOLL_CTL_DEL, listener, nullptr);
+        loop.accepting = false;
+        loop.resume = chrono::steady_clock::now() + chrono::milliseconds(AcceptBackoffMs);
+    }
+
+    void resumeAccepting(Loop& loop) {
+        epoll_event listen{};
+        listen.events = EPOLLIN | EPOLLEXCLUSIVE;
+        listen.data.fd = listener;
+        if (epoll_ctl(loop.epoll, EPOLL_CTL_ADD, listener, &listen) == 0) {
+            loop.accepting = true;
+        } else {
+            loop.resume = chrono::steady_clock::now() + chrono::milliseconds(AcceptBackoffMs);
+        }
+    }
+
+    //read what has arrived and apply every complete request; false once the client is gone
+    bool readAndApply(Connection& connection) {
+        if (connection.out.size() >= MaxPendingReply) return true;
+        size_t old = connection.in.size();
+        connection.in.resize(old + ReadBytes);
+        ssize_t got = read(connection.fd, connection.in.data() + old, ReadBytes);
+        if (got <= 0) {
+            connection.in.resize(old);
+            return got < 0 && (errno == EAGAIN || errno == EINTR);
+        }
+        connection.in.resize(old + (size_t)got);
+
+        size_t used = 0, applied = 0;
+        vector<int> inserts;
+        const vector<char>& in = connection.in;
+        vector<char>& out = connection.out;
+        while (in.size() - used >= TreeProtocol::HeaderBytes) {
+            uint8_t op = (uint8_t)in[used];
+            int32_t value = TreeProtocol::readInt(&in[used + 1]);
+            if (op == TreeProtocol::OpBatchInsert) {
+                if ((uint32_t)value > TreeProtocol::MaxBatch) return false;
+                size_t bytes = TreeProtocol::HeaderBytes + (size_t)(uint32_t)value * sizeof(int32_t);
+                if (in.size() - used < bytes) break;
+                for (uint32_t k = 0; k < (uint32_t)value; k++) {
+                    inserts.push_back(TreeProtocol::readInt(&in[used + TreeProtocol::HeaderBytes + k * sizeof(int32_t)]));
+                }
+                out.push_back(1);
+                used += bytes;
+                applied++;
+                continue;
+            }
+            if (op == TreeProtocol::OpInsert) {
+                // Inserts are held back and applied together before anything that could see them
+                inserts.push_back(value);
+                out.push_back(1);
+            } else {
+                applyInserts(inserts);
+                if (op == TreeProtocol::OpRemove) {
+                    set.remove(value);
+                    out.push_back(1);
+                } else if (op == TreeProtocol::OpContains) {
+                    out.push_back(set.contains(value) ? 1 : 0);
+                } else if (op == TreeProtocol::OpSize) {
+                    uint64_t size = set.size();
+                    const char* bytes = reinterpret_cast<const char*>(&size);
+                    out.insert(out.end(), bytes, bytes + sizeof(size));
+                } else {
+                    return false; // not speaking this protocol
+                }
+            }
+            used += TreeProtocol::HeaderBytes;
+            applied++;
+        }
+        applyInserts(inserts);
+        connection.in.erase(connection.in.begin(), connection.in.begin() + used);
+        if (applied) {
+            requests += applied;
+            reads++;
+        }
+        return true;
+    }
+
+    void applyInserts(vector<int>& inserts) {
+        if (inserts.empty()) return;
+        // This loop is already one of one per core, so the batch stays on this thread
+        set.insertBatchInline(inserts);
+        inserts.clear();
+    }
+
+    //write pending replies; watch for EPOLLOUT only while some are left, and stop
+    //watching EPOLLIN while a client lets too many of them pile up
+    bool flush(Loop& loop, Connection& connection) {
+        size_t sent = 0;
+        while (sent < connection.out.size()) {
+            ssize_t put = send(connection.fd, connection.out.data() + sent, connection.out.size() - sent, MSG_NOSIGNAL);
+            if (put < 0) {
+                if (errno == EINTR) continue;
+                if (errno == EAGAIN) break;
+                return false;
+            }
+            sent += (size_t)put;
+        }
+        connection.out.erase(connection.out.begin(), connection.out.begin() + sent);
+        uint32_t want = (connection.out.size() < MaxPendingReply ? (uint32_t)EPOLLIN : 0) |
+                        (connection.out.empty() ? 0 : (uint32_t)EPOLLOUT);
+        if (want != connection.watching) {
+            epoll_event event{};
+            event.events = want;
+            event.data.fd = connection.fd;
+            epoll_ctl(loop.epoll, EPOLL_CTL_MOD, connection.fd, &event);
+            connection.watching = want;
+        }
+        return true;
+    }
+};
+
+// Blocking client for TreeServer. The single calls wait for their reply; queue() and
+// sendQueued() pipeline many requests and read all replies in one go. The replies are
+// only read once every request is sent, so keep a pipeline to well under a million
+// requests or the two ends end up waiting on each other.
+class TreeClient {
+public:
+    explicit TreeClient(const string& socketPath) {
+        fd = socket(AF_UNIX, SOCK_STREAM | SOCK_CLOEXEC, 0);
+        if (fd < 0) throw runtime_error(string("TreeClient: socket failed: ") + strerror(errno));
+        sockaddr_un address = TreeServer::unixAddress(socketPath);
+        if (connect(fd, (sockaddr*)&address, sizeof(address)) != 0) {
+            int error = errno;
+            close(fd);
+            throw runtime_error("TreeClient: cannot connect to " + socketPath + ": " + strerror(error));
+        }
+    }
+
+    ~TreeClient() {
+        close(fd);
+    }
+
+    TreeClient(const TreeClient&) = delete;
+    TreeClient& operator=(const TreeClient&) = delete;
+
+    void insert(int key) {
+        call(TreeProtocol::OpInsert, key, 1);
+    }
+
+    void remove(int key) {
+        call(TreeProtocol::OpRemove, key, 1);
+    }
+
+    bool contains(int key) {
+        return call(TreeProtocol::OpContains, key, 1)[0] != 0;
+    }
+
+    uint64_t size() {
+        vector<char> reply = call(TreeProtocol::OpSize, 0, sizeof(uint64_t));
+        uint64_t value;
+        memcpy(&value, reply.data(), sizeof(value));
+        return value;
+    }
+
+    // Insert many keys with one request
+    void insertBatch(const vector<int>& keys) {
+        for (size_t i = 0; i < keys.size(); i += TreeProtocol::MaxBatch) {
+            size_t count = min(keys.size() - i, (size_t)TreeProtocol::MaxBatch);
+            TreeProtocol::put(pending, TreeProtocol::OpBatchInsert, (int32_t)count);
+            const char* bytes = reinterpret_cast<const char*>(keys.data() + i);
+            pending.insert(pending.end(), bytes, bytes + count * sizeof(int32_t));
+            expected += 1;
+        }
+        sendQueued();
+    }
+
+    // Add a request to the pipeline without sending it (not OpSize or OpBatchInsert)
+    void queue(uint8_t op, int key) {
+        TreeProtocol::put(pending, op, key);
+        expected += 1;
+    }
+
+    // Send every queued request, then read their one-byte replies in order
+    vector<char> sendQueued() {
+        writeAll(pending.data(), pending.size());
+        pending.clear();
+        vector<char> replies(expected);
+        readAll(replies.data(), replies.size());
+        expected = 0;
+        return replies;
+    }
+
+private:
+    int fd;
+    vector<char> pending;
+    size_t expected = 0;
+
+    vector<char> call(uint8_t op, int key, size_t replyBytes) {
+        if (!pending.empty()) sendQueued();
+        char request[TreeProtocol::HeaderBytes];
+        request[0] = (char)op;
+        memcpy(request + 1, &key, sizeof(int32_t));
+        writeAll(request, sizeof(request));
+        vector<char> reply(replyBytes);
+        readAll(reply.data(), reply.size());
+        return reply;
+    }
+
+    void writeAll(const char* data, size_t bytes) {
+        while (bytes > 0) {
+            ssize_t put = send(fd, data, bytes, MSG_NOSIGNAL);
+            if (put < 0 && errno == EINTR) continue;
+            if (put < 0) throw runtime_error(string("TreeClient: send failed: ") + strerror(errno));
+            data += put;
+            bytes -= (size_t)put;
+        }
+    }
+
+    void readAll(char* data, size_t bytes) {
+        while (bytes > 0) {
+            ssize_t got = read(fd, data, bytes);
+            if (got < 0 && errno == EINTR) continue;
+            if (got <= 0) throw runtime_error("TreeClient: connection closed");
+            data += got;
+            bytes -= (size_t)got;
+        }
+    }
+};
+
+#endif /* __linux__ */
+
+#endif /* TreeServer_h */
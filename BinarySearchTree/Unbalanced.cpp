@@ -26,8 +26,38 @@ using namespace std;
 class BST {
 public:
     Node* root;
+    bool countDuplicates; // multiset mode: one node per key plus an occurrence count
 
-    BST() : root(nullptr) {}
+    explicit BST(bool countDuplicates = false) : root(nullptr), countDuplicates(countDuplicates) {}
+
+    ~BST() {
+        destroyTree(root);
+    }
+
+    // A copy would share nodes with this tree, use clone() for a deep copy
+    BST(const BST&) = delete;
+    BST& operator=(const BST&) = delete;
+
+    BST(BST&& other) noexcept : root(other.root), countDuplicates(other.countDuplicates) {
+        other.root = nullptr;
+    }
+
+    BST& operator=(BST&& other) noexcept {
+        if (this != &other) {
+            destroyTree(root);
+            root = other.root;
+            other.root = nullptr;
+            countDuplicates = other.countDuplicates;
+        }
+        return *this;
+    }
+
+    /** Deep copy of the tree */
+    BST clone() const {
+        BST copy(countDuplicates);
+        copy.root = cloneTree(root);
+        return copy;
+    }
 
     /** Task 2: Insert a node into the tree to form an unbalanced tree */
     void insert(int data) {
@@ -36,6 +66,10 @@ public:
 
     Node* insertRec(Node* node, int data) {
         if (!node) return new Node(data);
+        if (countDuplicates && data == node->data) {
+            node->count++;
+            return node;
+        }
 
         if (data < node->data) {
             node->left = insertRec(node->left, data);
@@ -48,9 +82,32 @@ public:
 
     /** Task 3: Remove a node from the tree */
     void remove(int data) {
+        // A counted key loses one occurrence before its node is unlinked
+        if (countDuplicates) {
+            Node* node = findNode(data);
+            if (node && node->count > 1) {
+                node->count--;
+                return;
+            }
+        }
         root = removeRec(root, data);
     }
 
+    /** Find the node holding data, or nullptr */
+    Node* findNode(int data) {
+        Node* current = root;
+        while (current && current->data != data) {
+            current = (data < current->data) ? current->left : current->right;
+        }
+        return current;
+    }
+
+    /** Number of copies of data in the tree; only above 1 when duplicates are counted */
+    int occurrences(int data) {
+        Node* node = findNode(data);
+        return node ? node->count : 0;
+    }
+
     Node* removeRec(Node* node, int data) {
         if (!node) return nullptr;
 
@@ -71,6 +128,7 @@ public:
 
             Node* temp = minValueNode(node->right);
             node->data = temp->data;
+            node->count = temp->count;
             node->right = removeRec(node->right, temp->data);
         }
         return node;
@@ -87,7 +145,7 @@ public:
     void inorderRec(Node* node) {
         if (!node) return;
         inorderRec(node->left);
-        cout << node->data << " ";
+        printKey(node);
         inorderRec(node->right);
     }
 
@@ -100,7 +158,7 @@ public:
     /** Helper function for pre-order traversal recursively */
     void preorderRec(Node* node) {
         if (!node) return;
-        cout << node->data << " ";
+        printKey(node);
         preorderRec(node->left);
         preorderRec(node->right);
     }
@@ -116,7 +174,7 @@ public:
         if (!node) return;
         postorderRec(node->left);
         postorderRec(node->right);
-        cout << node->data << " ";
+        printKey(node);
     }
 
     /** Task 6: Perform a post-order traversal */
@@ -132,7 +190,7 @@ public:
         q.push(node);
         while (!q.empty()) {
             Node* current = q.front();
-            cout << current->data << " ";
+            printKey(current);
             q.pop();
             if (current->left) q.push(current->left);
             if (current->right) q.push(current->right);
@@ -149,7 +207,7 @@ public:
     void bfsRec(queue<Node*> q) {
         if (q.empty()) return;
         Node* current = q.front();
-        cout << current->data << " ";
+        printKey(current);
         q.pop();
         if (current->left) q.push(current->left);
         if (current->right) q.push(current->right);
@@ -171,7 +229,7 @@ public:
         s.push(node);
         while (!s.empty()) {
             Node* current = s.top();
-            cout << current->data << " ";
+            printKey(current);
             s.pop();
             if (current->right) s.push(current->right);
             if (current->left) s.push(current->left);
@@ -187,7 +245,7 @@ public:
     /** Helper function for DFS traversal recursively */
     void dfsRec(Node* node) {
         if (!node) return;
-        cout << node->data << " ";
+        printKey(node);
         dfsRec(node->left);
         dfsRec(node->right);
     }
@@ -0,0 +1,103 @@
+#include <iostream>
+#include <algorithm>
+#include <chrono>
+#include <random>
+#include <vector>
+#include "BST.h"
+#include "VebLayout.h"
+using namespace std;
+
+/**
+ * Van Emde Boas Layout
+ *
+ * A search reads one node per level. In a pointer tree every level can be a cache miss.
+ * The van Emde Boas layout cuts the tree at half its height and stores the top half
+ * first, then each bottom piece, and cuts every piece again the same way.
+ *
+ * Stick figure of a tree with 15 nodes (numbers are positions in the array):
+ *
+ *                    0
+ *              /           \
+ *             1             2
+ *           /   \         /   \
+ *          3     6       9     12
+ *         / \   / \     / \    / \
+ *        4   5 7   8  10  11 13   14
+ *
+ * In this figure:
+ * - The top piece `0 1 2` is stored first.
+ * - Each bottom piece (`3 4 5`, `6 7 8`, ...) is stored in one block right after it.
+ * - A search only jumps to a new block when it leaves a piece, at every size of piece,
+ *   so it works well for cache lines and pages alike.
+ */
+
+/** Pointer tree used as a baseline */
+Node* insertPointer(Node* root, int data) {
+    Node** link = &root;
+    while (*link) {
+        link = (data < (*link)->data) ? &(*link)->left : &(*link)->right;
+    }
+    *link = new Node(data);
+    return root;
+}
+
+bool containsPointer(const Node* node, int data) {
+    while (node) {
+        if (data == node->data) return true;
+        node = (data < node->data) ? node->left : node->right;
+    }
+    return false;
+}
+
+template <typename F>
+long long timeMs(F f) {
+    auto start = chrono::steady_clock::now();
+    f();
+    return chrono::duration_cast<chrono::milliseconds>(chrono::steady_clock::now() - start).count();
+}
+
+int main() {
+    Node* small = nullptr;
+    for (int key : {8, 4, 12, 2, 6, 10, 14, 1, 3, 5, 7, 9, 11, 13, 15}) {
+        small = insertPointer(small, key);
+    }
+    VebTree smallVeb = VebTree::fromTree(small);
+    cout << "Van Emde Boas layout of 1..15: ";
+    for (int key : smallVeb.data()) cout << key << " ";
+    cout << endl;
+    destroyTree(small);
+
+    const int n = 4000000;
+    mt19937 rng(3);
+    vector<int> keys(n);
+    for (int& key : keys) key = (int)(rng() % 1000000000);
+    vector<int> probes(n);
+    for (int& probe : probes) probe = (int)(rng() % 1000000000);
+
+    Node* root = nullptr;
+    for (int key : keys) root = insertPointer(root, key);
+    VebTree veb = VebTree::fromTree(root);
+    vector<int> sorted(keys);
+    sort(sorted.begin(), sorted.end());
+    sorted.erase(unique(sorted.begin(), sorted.end()), sorted.end());
+
+    size_t hits[3] = {0, 0, 0};
+    long long pointerMs = timeMs([&] {
+        for (int probe : probes) hits[0] += containsPointer(root, probe);
+    });
+    long long arrayMs = timeMs([&] {
+        for (int probe : probes) hits[1] += binary_search(sorted.begin(), sorted.end(), probe);
+    });
+    long long vebMs = timeMs([&] {
+        for (int probe : probes) hits[2] += veb.contains(probe);
+    });
+
+    cout << "\n" << n << " lookups in " << veb.size() << " keys:\n";
+    cout << "Pointer tree:      " << pointerMs << " ms (" << hits[0] << " hits)\n";
+    cout << "Sorted array:      " << arrayMs << " ms (" << hits[1] << " hits)\n";
+    cout << "Van Emde Boas:     " << vebMs << " ms (" << hits[2] << " hits), "
+         << veb.memoryBytes() / (1 << 20) << " MB\n";
+
+    destroyTree(root);
+    return 0;
+}
@@ -0,0 +1,177 @@
+//
+//  VebLayout.h
+//  BinarySearchTrees
+//
+
+#ifndef VebLayout_h
+#define VebLayout_h
+
+#include <algorithm>
+#include <climits>
+#include <cstdint>
+#include <fstream>
+#include <stack>
+#include <string>
+#include <vector>
+
+using namespace std;
+
+// Reads the key of a tree node, whether the node calls it `data` (BST.h) or `key`
+// (the AVL trees)
+template <typename NodeT>
+auto nodeKey(const NodeT* node, int) -> decltype(node->data) {
+    return node->data;
+}
+
+template <typename NodeT>
+auto nodeKey(const NodeT* node, long) -> decltype(node->key) {
+    return node->key;
+}
+
+// Read-only search tree stored in van Emde Boas order in one contiguous array.
+// The tree is split at half its height into a top tree and the bottom trees hanging
+// off it; the top tree is stored first, then each bottom tree, each laid out the same
+// way recursively. Whatever the cache line or page size B, a search then touches
+// O(log_B n) blocks, with no tuning. There are no child pointers: positions are
+// computed from three small tables per depth (Brodal, Fagerberg and Jacob's method).
+class VebTree {
+public:
+    VebTree() : count(0), height(0), hasMaxKey(false) {}
+
+    /** Build from keys that are sorted in increasing order */
+    static VebTree fromSorted(const vector<int>& sorted) {
+        VebTree tree;
+        tree.build(sorted);
+        return tree;
+    }
+
+    /** Export any pointer tree with left/right children, in in-order */
+    template <typename NodeT>
+    static VebTree fromTree(const NodeT* root) {
+        vector<int> keys;
+        stack<const NodeT*> s;
+        const NodeT* current = root;
+        while (current || !s.empty()) {
+            while (current) {
+                s.push(current);
+                current = current->left;
+            }
+            current = s.top();
+            s.pop();
+            keys.push_back(nodeKey(current, 0));
+            current = current->right;
+        }
+        // BSTs that accept duplicates yield runs of equal keys
+        keys.erase(unique(keys.begin(), keys.end()), keys.end());
+        return fromSorted(keys);
+    }
+
+    /** Search for a key */
+    bool contains(int key) const {
+        // INT_MAX also pads the tree up to a perfect shape
+        if (key == INT_MAX) return hasMaxKey;
+        size_t pos[64];
+        size_t index = 1; // breadth-first number of the current node, root = 1
+        for (int d = 0; d < height; d++) {
+            size_t p = (d == 0) ? 0 : pos[topDepth[d]] + topSize[d] + (index & topSize[d]) * bottomSize[d];
+            pos[d] = p;
+            int k = layout[p];
+            if (key == k) return true;
+            index = 2 * index + (key > k ? 1 : 0);
+        }
+        return false;
+    }
+
+    size_t size() const {
+        return count;
+    }
+
+    /** Bytes used by the key array */
+    size_t memoryBytes() const {
+        return layout.size() * sizeof(int);
+    }
+
+    /** The layout, ready to be written out or mapped by another process */
+    const vector<int>& data() const {
+        return layout;
+    }
+
+    /** Write the layout to a binary file */
+    bool save(const string& path) const {
+        ofstream out(path, ios::binary);
+        uint64_t header[2] = {count, (uint64_t)hasMaxKey};
+        out.write(reinterpret_cast<const char*>(header), sizeof(header));
+        out.write(reinterpret_cast<const char*>(layout.data()), layout.size() * sizeof(int));
+        return (bool)out;
+    }
+
+    /** Read a layout written by save() */
+    static bool load(const string& path, VebTree& tree) {
+        ifstream in(path, ios::binary);
+        uint64_t header[2];
+        if (!in.read(reinterpret_cast<char*>(header), sizeof(header))) return false;
+        tree.count = header[0];
+        tree.hasMaxKey = header[1] != 0;
+        tree.computeTables();
+        tree.layout.assign(((size_t)1 << tree.height) - 1, INT_MAX);
+        return (bool)in.read(reinterpret_cast<char*>(tree.layout.data()),
+                             tree.layout.size() * sizeof(int));
+    }
+
+private:
+    vector<int> layout;
+    size_t count;
+    int height;
+    bool hasMaxKey;
+    // For each depth d > 0: d is the root level of the bottom trees of some split.
+    // topSize[d] and bottomSize[d] are the sizes of the top tree and of each bottom
+    // tree of that split, topDepth[d] is the depth of the top tree's root.
+    vector<size_t> topSize;
+    vector<size_t> bottomSize;
+    vector<int> topDepth;
+
+    void computeTables() {
+        height = 0;
+        while ((((size_t)1 << height) - 1) < count) height++;
+        topSize.assign(height, 0);
+        bottomSize.assign(height, 0);
+        topDepth.assign(height, 0);
+        split(0, height);
+    }
+
+    void split(int depth, int h) {
+        if (h <= 1) return;
+        int topHeight = h / 2;
+        int bottomHeight = h - topHeight;
+        int boundary = depth + topHeight;
+        topSize[boundary] = ((size_t)1 << topHeight) - 1;
+        bottomSize[boundary] = ((size_t)1 << bottomHeight) - 1;
+        topDepth[boundary] = depth;
+        split(depth, topHeight);
+        split(boundary, bottomHeight);
+    }
+
+    void build(const vector<int>& sorted) {
+        count = sorted.size();
+        hasMaxKey = count > 0 && sorted.back() == INT_MAX;
+        computeTables();
+        size_t slots = ((size_t)1 << height) - 1;
+        layout.assign(slots, INT_MAX);
+        // Walk the perfect tree in breadth-first order; a parent's position is
+        // always known before its children's
+        vector<size_t> position(slots + 1, 0);
+        for (size_t index = 1; index <= slots; index++) {
+            int d = 0;
+            while ((index >> (d + 1)) != 0) d++;
+            if (d > 0) {
+                size_t ancestor = index >> (d - topDepth[d]);
+                position[index] = position[ancestor] + topSize[d] + (index & topSize[d]) * bottomSize[d];
+            }
+            // In-order rank of this node in a perfect tree of the given height
+            size_t rank = ((2 * (index - ((size_t)1 << d)) + 1) << (height - 1 - d)) - 1;
+            if (rank < count) layout[position[index]] = sorted[rank];
+        }
+    }
+};
+
+#endif /* VebLayout_h */
@@ -0,0 +1,214 @@
+//
+//  WorkStealingPool.h
+//  BinarySearchTrees
+//
+
+#ifndef WorkStealingPool_h
+#define WorkStealingPool_h
+
+#include <atomic>
+#include <condition_variable>
+#include <deque>
+#include <exception>
+#include <functional>
+#include <memory>
+#include <mutex>
+#include <thread>
+#include <vector>
+
+using namespace std;
+
+// Fixed set of worker threads, each with its own task deque.
+// A worker pushes and pops its own tasks at the back (newest first, which keeps the
+// subtree it just split hot in cache) and steals from the front of the other deques
+// when it runs dry, so big old tasks move between threads and small new ones stay put.
+class WorkStealingPool {
+public:
+    explicit WorkStealingPool(unsigned threadCount = thread::hardware_concurrency())
+        : stopping(false), queued(0), sleepers(0) {
+        if (threadCount == 0) threadCount = 1;
+        // One extra queue for tasks submitted from threads outside the pool
+        for (unsigned i = 0; i <= threadCount; i++) {
+            queues.push_back(unique_ptr<WorkQueue>(new WorkQueue()));
+        }
+        for (unsigned i = 0; i < threadCount; i++) {
+            workers.emplace_back([this, i] { workerLoop(i); });
+        }
+    }
+
+    WorkStealingPool(const WorkStealingPool&) = delete;
+    WorkStealingPool& operator=(const WorkStealingPool&) = delete;
+
+    ~WorkStealingPool() {
+        {
+            lock_guard<mutex> lock(sleepMutex);
+            stopping = true;
+        }
+        wake.notify_all();
+        for (auto& worker : workers) worker.join();
+    }
+
+    // Process-wide pool shared by the tree operations
+    static WorkStealingPool& shared() {
+        static WorkStealingPool pool;
+        return pool;
+    }
+
+    size_t size() const {
+        return workers.size();
+    }
+
+    // Queue a task on the calling worker's deque, or on the external queue
+    void submit(function<void()> task) {
+        WorkQueue& q = *queues[ownQueueIndex()];
+        {
+            lock_guard<mutex> lock(q.m);
+            q.tasks.push_back(move(task));
+        }
+        queued.fetch_add(1, memory_order_seq_cst);
+        // A worker counts itself as a sleeper before it checks queued for the last time,
+        // so either it sees this task or we see it and pass through sleepMutex, which
+        // only lets us in once it is really waiting
+        if (sleepers.load(memory_order_seq_cst) > 0) {
+            lock_guard<mutex> lock(sleepMutex);
+        }
+        wake.notify_one();
+    }
+
+    // Run one queued task on the calling thread, if there is one.
+    // Threads waiting on a TaskGroup call this so they help instead of blocking.
+    bool runPendingTask() {
+        function<void()> task;
+        if (!popOwn(task) && !steal(task)) return false;
+        task();
+        return true;
+    }
+
+private:
+    struct WorkQueue {
+        mutex m;
+        deque<function<void()>> tasks;
+    };
+
+    vector<unique_ptr<WorkQueue>> queues;
+    vector<thread> workers;
+    bool stopping;
+    atomic<int> queued;
+    atomic<int> sleepers; // workers inside wait(), or about to be
+    mutex sleepMutex;
+    condition_variable wake;
+
+    static inline thread_local WorkStealingPool* currentPool = nullptr;
+    static inline thread_local size_t currentIndex = 0;
+
+    size_t ownQueueIndex() const {
+        return currentPool == this ? currentIndex : workers.size();
+    }
+
+    bool popOwn(function<void()>& task) {
+        WorkQueue& q = *queues[ownQueueIndex()];
+        lock_guard<mutex> lock(q.m);
+        if (q.tasks.empty()) return false;
+        task = move(q.tasks.back());
+        q.tasks.pop_back();
+        queued.fetch_sub(1, memory_order_relaxed);
+        return true;
+    }
+
+    // The first pass skips busy deques; only if one was busy does a second pass wait for
+    // their locks, so a task is never missed because its deque was locked at that moment
+    bool steal(function<void()>& task) {
+        size_t n = queues.size();
+        size_t start = ownQueueIndex() + 1;
+        bool contended = false;
+        for (int pass = 0; pass < 2; pass++) {
+            for (size_t i = 0; i < n; i++) {
+                WorkQueue& q = *queues[(start + i) % n];
+                unique_lock<mutex> lock(q.m, defer_lock);
+                if (pass == 0) {
+                    if (!lock.try_lock()) {
+                        contended = true;
+                        continue;
+                    }
+                } else {
+                    lock.lock();
+                }
+                if (q.tasks.empty()) continue;
+                task = move(q.tasks.front());
+                q.tasks.pop_front();
+                queued.fetch_sub(1, memory_order_relaxed);
+                return true;
+            }
+            if (!contended) break;
+        }
+        return false;
+    }
+
+    void workerLoop(size_t index) {
+        currentPool = this;
+        currentIndex = index;
+        while (true) {
+            if (runPendingTask()) continue;
+            unique_lock<mutex> lock(sleepMutex);
+            if (stopping) return;
+            sleepers.fetch_add(1, memory_order_seq_cst);
+            wake.wait(lock, [this] {
+                return stopping || queued.load(memory_order_seq_cst) > 0;
+            });
+            sleepers.fetch_sub(1, memory_order_relaxed);
+            if (stopping && queued.load(memory_order_acquire) == 0) return;
+        }
+    }
+};
+
+// Fork/join scope on a WorkStealingPool.
+// run() forks a task, wait() joins all of them and rethrows the first exception.
+// The waiting thread keeps executing queued tasks, so nested groups cannot deadlock.
+class TaskGroup {
+public:
+    explicit TaskGroup(WorkStealingPool& p) : pool(p), pending(0) {}
+
+    TaskGroup(const TaskGroup&) = delete;
+    TaskGroup& operator=(const TaskGroup&) = delete;
+
+    ~TaskGroup() {
+        join();
+    }
+
+    template <typename F>
+    void run(F task) {
+        pending.fetch_add(1, memory_order_relaxed);
+        pool.submit([this, task]() mutable {
+            try {
+                task();
+            } catch (...) {
+                lock_guard<mutex> lock(errorMutex);
+                if (!error) error = current_exception();
+            }
+            pending.fetch_sub(1, memory_order_release);
+        });
+    }
+
+    void wait() {
+        join();
+        if (error) {
+            exception_ptr e = error;
+            error = nullptr;
+            rethrow_exception(e);
+        }
+    }
+
+private:
+    WorkStealingPool& pool;
+    atomic<int> pending;
+    mutex errorMutex;
+    exception_ptr error;
+
+    void join() {
+        while (pending.load(memory_order_acquire) > 0) {
+            if (!pool.runPendingTask()) this_thread::yield();
+        }
+    }
+};
+
+#endif /* WorkStealingPool_h */
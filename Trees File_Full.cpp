@@ -4,7 +4,11 @@
 #include <algorithm>
 #include <queue>
 #include <stack>
+#include <vector>
+#include <utility>
+#include <memory>
 #include "TreePrinter.h"
+#include "BinarySearchTree/BloomFilter.h"
 using namespace std;
 
 class AVLTree {
@@ -14,11 +18,105 @@ public:
         Node* left;
         Node* right;
         int height;
-        Node(int k) : key(k), left(nullptr), right(nullptr), height(1) {}
+        bool deleted; //tombstone: still links the tree, but the key is gone
+        Node(int k) : key(k), left(nullptr), right(nullptr), height(1), deleted(false) {}
     };
     
     Node* root;
-    AVLTree() : root(nullptr) {}
+    unique_ptr<BloomFilter> filter; //optional, see enableFilter()
+    size_t removedSinceRebuild;
+    size_t nodes;          //nodes in the tree, tombstones included
+    size_t tombstones;     //nodes marked deleted
+    double tombstoneRatio; //0: deleteNode unlinks at once, see enableTombstones()
+    AVLTree() : root(nullptr), removedSinceRebuild(0), nodes(0), tombstones(0), tombstoneRatio(0) {}
+    
+    ~AVLTree() {
+        destroyTree(root);
+    }
+    
+    //copying would share nodes between two trees, use clone() for a deep copy
+    AVLTree(const AVLTree&) = delete;
+    AVLTree& operator=(const AVLTree&) = delete;
+    
+    AVLTree(AVLTree&& other) noexcept
+        : root(other.root), filter(move(other.filter)), removedSinceRebuild(other.removedSinceRebuild),
+          nodes(other.nodes), tombstones(other.tombstones), tombstoneRatio(other.tombstoneRatio) {
+        other.root = nullptr;
+        other.nodes = other.tombstones = 0;
+    }
+    
+    AVLTree& operator=(AVLTree&& other) noexcept {
+        if (this != &other) {
+            destroyTree(root);
+            root = other.root;
+            other.root = nullptr;
+            filter = move(other.filter);
+            removedSinceRebuild = other.removedSinceRebuild;
+            nodes = other.nodes;
+            tombstones = other.tombstones;
+            tombstoneRatio = other.tombstoneRatio;
+            other.nodes = other.tombstones = 0;
+        }
+        return *this;
+    }
+    
+    //deep copy of the tree
+    AVLTree clone() const {
+        AVLTree copy;
+        copy.root = cloneTree(root);
+        if (filter) copy.filter.reset(new BloomFilter(*filter));
+        copy.removedSinceRebuild = removedSinceRebuild;
+        copy.nodes = nodes;
+        copy.tombstones = tombstones;
+        copy.tombstoneRatio = tombstoneRatio;
+        return copy;
+    }
+    
+    //free every node without recursion
+    //rotate the left child up until there is none, then free the node and go right
+    void destroyTree(Node* node) {
+        while (node) {
+            if (node->left) {
+                Node* left = node->left;
+                node->left = left->right;
+                left->right = node;
+                node = left;
+            } else {
+                Node* right = node->right;
+                delete node;
+                node = right;
+            }
+        }
+    }
+    
+    //copy node by node using a stack instead of recursion
+    Node* cloneTree(const Node* source) const {
+        if (!source) return nullptr;
+        Node* copy = copyNode(source);
+        vector<pair<const Node*, Node*>> pending;
+        pending.push_back(make_pair(source, copy));
+        while (!pending.empty()) {
+            const Node* from = pending.back().first;
+            Node* to = pending.back().second;
+            pending.pop_back();
+            if (from->left) {
+                to->left = copyNode(from->left);
+                pending.push_back(make_pair(from->left, to->left));
+            }
+            if (from->right) {
+                to->right = copyNode(from->right);
+                pending.push_back(make_pair(from->right, to->right));
+            }
+        }
+        return copy;
+    }
+    
+    Node* copyNode(const Node* source) const {
+        Node* copy = new Node(source->key);
+        copy->height = source->height;
+        copy->deleted = source->deleted;
+        return copy;
+    }
     
     //height
     int height(Node* node) {
@@ -53,7 +151,11 @@ public:
     
     //insert the node
     Node* insert(Node* node, int key) {
-        if(!node) return new Node(key);
+        if(!node) {
+            if (filter) filter->add(key);
+            nodes++;
+            return new Node(key);
+        }
         if (key < node->key) {
             node->left = insert(node->left, key);
         }
@@ -61,6 +163,13 @@ public:
             node->right = insert(node->right, key);
         }
         else {
+            //a tombstone for the key comes back to life, no new node needed;
+            //a filter rebuilt since the delete has dropped the key
+            if (node->deleted) {
+                node->deleted = false;
+                tombstones--;
+                if (filter) filter->add(key);
+            }
             return node;
         }
         
@@ -99,62 +208,192 @@ public:
     }
     
     //delete the node
+    //in tombstone mode the node is only marked, and root has to be the tree's root
     Node* deleteNode(Node* root, int key){
+        if (tombstoneRatio > 0) return markDeleted(root, key);
+        return unlinkNode(root, key);
+    }
+    
+    //take the node out of the tree and rebalance on the way back up
+    Node* unlinkNode(Node* root, int key){
         if (!root) return root;
         
         if (key < root->key){
-            root->left = deleteNode(root->left, key);
+            root->left = unlinkNode(root->left, key);
         }
         else if (key > root->key) {
-            root->right = deleteNode(root->right, key);
+            root->right = unlinkNode(root->right, key);
         }
         else {
             if ((root->left == nullptr) || (root->right == nullptr)){
-                Node* temp = root->left ? root-> left : root->right;
-                if(!temp) {
-                    temp = root;
-                    root = nullptr;
-                } else {
-                    *root = *temp;
-                }
-                delete temp;
-            } else {
-                Node* temp = minValueNode(root->right);
-                root->key = temp->key;
-                root->right = deleteNode(root->right, temp->key);
+                //the child's subtree is already balanced and keeps its height
+                Node* child = root->left ? root->left : root->right;
+                if (root->deleted) tombstones--;
+                delete root;
+                nodes--;
+                //the filter can't forget a key, it gets rebuilt once enough are gone
+                if (filter) removedSinceRebuild++;
+                return child;
             }
+            if (root->deleted) tombstones--;
+            Node* temp = minValueNode(root->right);
+            root->key = temp->key;
+            root->deleted = temp->deleted;
+            //the successor's node goes, so it is unmarked first to keep the count right
+            temp->deleted = false;
+            root->right = unlinkNode(root->right, temp->key);
         }
         
-        if (!root) return root;
-        
         //check the height
         root->height = 1 + max(height(root->left), height(root->right));
         
+        //after a delete the key says nothing about where the tree is heavy,
+        //so the children's balance picks the rotation
         int balance = getBalance(root);
-        
-        //check the balance of the tree
-        if (balance > 1 && key < root->left->key){
+        if (balance > 1 && getBalance(root->left) >= 0){
             return rightRotate(root);
         }
-        if (balance < -1 && key > root->right->key) {
-            return leftRotate(root);
-        }
-        if (balance > 1 && key > root->left->key){
+        if (balance > 1){
             root->left = leftRotate(root->left);
             return rightRotate(root);
         }
-        if (balance < -1 && key < root->right->key){
+        if (balance < -1 && getBalance(root->right) <= 0) {
+            return leftRotate(root);
+        }
+        if (balance < -1){
             root->right = rightRotate(root->right);
             return leftRotate(root);
         }
         return root;
     }
     
+    //tombstone mode: deleteNode marks the node instead of unlinking it, so a burst of
+    //deletes (say, expired keys) costs one descent each and no rotations; once more than
+    //ratio of the nodes are tombstones they are all purged in one rebuild
+    void enableTombstones(double ratio = 0.25) {
+        tombstoneRatio = min(max(ratio, 0.01), 1.0);
+    }
+    
+    void disableTombstones() {
+        purge();
+        tombstoneRatio = 0;
+    }
+    
+    Node* markDeleted(Node* root, int key) {
+        Node* node = root;
+        while (node && node->key != key) {
+            node = key < node->key ? node->left : node->right;
+        }
+        if (!node || node->deleted) return root;
+        node->deleted = true;
+        tombstones++;
+        if (filter) removedSinceRebuild++;
+        if (tombstones > tombstoneRatio * nodes) purge();
+        return this->root;
+    }
+    
+    //free every tombstone at once and relink the live nodes into a perfectly balanced
+    //tree; finding the affected subtrees would take a full walk anyway, so the whole
+    //tree is rebuilt, which costs O(n) for every ratio * n deletes
+    void purge() {
+        if (tombstones == 0) return;
+        vector<Node*> live;
+        live.reserve(nodes - tombstones);
+        stack<Node*> s;
+        Node* node = root;
+        while (node || !s.empty()) {
+            while (node) {
+                s.push(node);
+                node = node->left;
+            }
+            node = s.top();
+            s.pop();
+            //the left subtree is done, so the node can go once its right link is saved
+            Node* right = node->right;
+            if (node->deleted) {
+                delete node;
+            } else {
+                live.push_back(node);
+            }
+            node = right;
+        }
+        root = linkBalanced(live, 0, live.size());
+        nodes = live.size();
+        tombstones = 0;
+    }
+    
+    //link sorted nodes [start, end) into a balanced subtree
+    Node* linkBalanced(vector<Node*>& sorted, size_t start, size_t end) {
+        if (start >= end) return nullptr;
+        size_t mid = start + (end - start) / 2;
+        Node* node = sorted[mid];
+        node->left = linkBalanced(sorted, start, mid);
+        node->right = linkBalanced(sorted, mid + 1, end);
+        node->height = 1 + max(height(node->left), height(node->right));
+        return node;
+    }
+    
+    //live keys, tombstones not counted
+    size_t size() const {
+        return nodes - tombstones;
+    }
+    
+    //search for a key, asking the Bloom filter first when there is one
+    bool contains(int key) {
+        if (filter) {
+            refreshFilter();
+            if (!filter->mayContain(key)) return false;
+        }
+        Node* node = root;
+        while (node && node->key != key) {
+            node = key < node->key ? node->left : node->right;
+        }
+        bool found = node && !node->deleted;
+        if (!found && filter) filter->recordFalsePositive();
+        return found;
+    }
+    
+    //keep a Bloom filter in front of contains() so most misses skip the descent
+    void enableFilter(size_t expectedKeys, double falsePositiveRate) {
+        vector<int> keys;
+        stack<Node*> s;
+        Node* node = root;
+        while (node || !s.empty()) {
+            while (node) {
+                s.push(node);
+                node = node->left;
+            }
+            node = s.top();
+            s.pop();
+            if (!node->deleted) keys.push_back(node->key);
+            node = node->right;
+        }
+        filter.reset(new BloomFilter(max(expectedKeys, keys.size()), falsePositiveRate));
+        for (int key : keys) filter->add(key);
+        removedSinceRebuild = 0;
+    }
+    
+    void disableFilter() {
+        filter.reset();
+        removedSinceRebuild = 0;
+    }
+    
+    //rebuild the filter once a quarter of its keys were deleted or it outgrew its size
+    void refreshFilter() {
+        bool stale = removedSinceRebuild * 4 > filter->keyCount();
+        bool overfull = filter->keyCount() > 2 * filter->capacity();
+        if (!stale && !overfull) return;
+        size_t live = filter->keyCount() - min(removedSinceRebuild, filter->keyCount());
+        unique_ptr<BloomFilter> old = move(filter);
+        enableFilter(max(old->capacity(), 2 * live), old->falsePositiveRate());
+        filter->carryStatsFrom(*old);
+    }
+    
     //inorder traversal
     void inorder(Node* root){
         if (root) {
             inorder(root->left);
-            cout << root->key << " ";
+            if (!root->deleted) cout << root->key << " ";
             inorder(root->right);
         }
     }
@@ -162,7 +401,7 @@ public:
     //pre-order traversal
     void preorder(Node* root) {
         if (root){
-            cout << root->key << " ";
+            if (!root->deleted) cout << root->key << " ";
             preorder(root->left);
             preorder(root->right);
         }
@@ -174,7 +413,7 @@ public:
         if (root){
             postorder(root->left);
             postorder(root->right);
-            cout << root->key << " ";
+            if (!root->deleted) cout << root->key << " ";
         }
     }
     
@@ -186,7 +425,7 @@ public:
         q.push(root);
         while(!q.empty()){
             Node* node = q.front();
-            cout << node->key << " ";
+            if (!node->deleted) cout << node->key << " ";
             q.pop();
             if (node->left){
                 q.push(node->left);
@@ -205,7 +444,7 @@ public:
         s.push(root);
         while(!s.empty()){
             Node* node = s.top();
-            cout << node->key << " ";
+            if (!node->deleted) cout << node->key << " ";
             s.pop();
             if(node->right){
                 s.push(node->right);
@@ -246,6 +485,27 @@ int main(){
     avl.root = avl.deleteNode(avl.root, 20);
     cout << "\nSelected node has been removed from the tree" << endl;
     printer.printPretty(avl.root, 1, 0);
+    
+    //Bloom filter in front of lookups
+    avl.enableFilter(100, 0.01);
+    cout << "Contains 30: " << (avl.contains(30) ? "yes" : "no") << endl;
+    cout << "Contains 25: " << (avl.contains(25) ? "yes" : "no") << endl;
+    BloomFilter::Stats stats = avl.filter->stats();
+    cout << "Filter answered " << stats.definiteMisses << " of " << stats.queries << " lookups" << endl;
+    
+    //tombstones: a burst of deletes only marks nodes, the purge rebuilds once
+    AVLTree expiring;
+    expiring.enableTombstones(0.4);
+    for (int key = 1; key <= 15; key++) expiring.root = expiring.insert(expiring.root, key);
+    for (int key = 2; key <= 8; key += 2) expiring.root = expiring.deleteNode(expiring.root, key);
+    cout << "Live keys after marking 2 4 6 8: ";
+    expiring.inorder(expiring.root);
+    cout << "\n" << expiring.tombstones << " tombstones, " << expiring.size() << " live keys" << endl;
+    expiring.root = expiring.deleteNode(expiring.root, 10);
+    expiring.root = expiring.deleteNode(expiring.root, 12);
+    expiring.root = expiring.deleteNode(expiring.root, 14);
+    cout << "Past 40% tombstones the tree is purged and rebuilt:" << endl;
+    printer.printPretty(expiring.root, 1, 0);
     return 0;
 }
 
@@ -270,6 +530,78 @@ public:
     
     BinaryTree() : root(nullptr) {}
     
+    ~BinaryTree() {
+        destroyTree(root);
+    }
+    
+    //copying would share nodes between two trees, use clone() for a deep copy
+    BinaryTree(const BinaryTree&) = delete;
+    BinaryTree& operator=(const BinaryTree&) = delete;
+    
+    BinaryTree(BinaryTree&& other) noexcept : root(other.root) {
+        other.root = nullptr;
+    }
+    
+    BinaryTree& operator=(BinaryTree&& other) noexcept {
+        if (this != &other) {
+            destroyTree(root);
+            root = other.root;
+            other.root = nullptr;
+        }
+        return *this;
+    }
+    
+    //deep copy of the tree
+    BinaryTree clone() const {
+        BinaryTree copy;
+        copy.root = cloneTree(root);
+        return copy;
+    }
+    
+    //free every node without recursion
+    //rotate the left child up until there is none, then free the node and go right
+    void destroyTree(Node* node) {
+        while (node) {
+            if (node->left) {
+                Node* left = node->left;
+                node->left = left->right;
+                left->right = node;
+                node = left;
+            } else {
+                Node* right = node->right;
+                delete node;
+                node = right;
+            }
+        }
+    }
+    
+    //copy node by node using a stack instead of recursion
+    Node* cloneTree(const Node* source) const {
+        if (!source) return nullptr;
+        Node* copy = copyNode(source);
+        vector<pair<const Node*, Node*>> pending;
+        pending.push_back(make_pair(source, copy));
+        while (!pending.empty()) {
+            const Node* from = pending.back().first;
+            Node* to = pending.back().second;
+            pending.pop_back();
+            if (from->left) {
+                to->left = copyNode(from->left);
+                pending.push_back(make_pair(from->left, to->left));
+            }
+            if (from->right) {
+                to->right = copyNode(from->right);
+                pending.push_back(make_pair(from->right, to->right));
+            }
+        }
+        return copy;
+    }
+    
+    Node* copyNode(const Node* source) const {
+        Node* copy = new Node(source->key);
+        return copy;
+    }
+    
     //Insert
     Node* insert(Node* node, int key){
         if(!node) return new Node(key);